@@ -83,14 +83,17 @@ typedef signed char int8_t;
 typedef unsigned short uint16_t;
 typedef signed short int16_t;
 
-void dtostrf( float val, int len, int precision, char *buf )
+unsigned long millis( void )
 {
-	sprintf_s(buf, 20, "%*.*f", len, precision, val);
+	return GetTickCount();
 }
 
-unsigned long millis( void )
+unsigned long micros( void )
 {
-	return GetTickCount();
+	LARGE_INTEGER freq, count;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&count);
+	return (unsigned long)((count.QuadPart / freq.QuadPart) * 1000000 + (count.QuadPart % freq.QuadPart) * 1000000 / freq.QuadPart);
 }
 
 void InitializeInput( void )
@@ -104,6 +107,7 @@ uint16_t g_PhysicalButtons;
 
 #define Sprintf sprintf_s
 #define strcpy_P strcpy_s
+#define memcpy_P memcpy
 #define Strcpy strcpy_s
 #define Strlen (int16_t)strlen
 #define strlen_P Strlen
@@ -171,16 +175,18 @@ void GenerateFont( void )
 		int y0 = 71 - (i/16) * 9;
 		const DWORD *pixels = (DWORD*)info.bmBits + y0 * 128 + x0;
 		fprintf(f, "\t");
-		for (int y = 0; y < 8; y++, pixels -= 128)
+		// 7 columns in the display's page layout (bit 0 is the top row), followed by the vertical offset of the glyph
+		for (int x = 0; x < 7; x++)
 		{
 			BYTE b = 0;
-			for (int x = 0; x < 7; x++)
+			for (int y = 0; y < 8; y++)
 			{
-				b = (b<<1) | ((pixels[6-x]&0xFFFFFF) == 0 ? 1 : 0);
+				b |= ((pixels[x - y * 128]&0xFFFFFF) == 0 ? 1 : 0) << y;
 			}
 			fprintf(f, "0x%02X, ", b);
 		}
 		char c = i;
+		fprintf(f, "0x%02X, ", (c >= 'a' && c <= 'z') ? 1 : 0); // lowercase letters are 1 pixel lower
 		if (i < 32)
 		{
 			fprintf(f, "// %s\n", specialNames[i]);
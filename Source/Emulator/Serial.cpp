@@ -80,7 +80,7 @@ void SerialEmulator::Print( const char *c )
 			WaitForSingleObject(m_OvWrite.hEvent, 500);
 		}
 	}
-	if (strcmp(c, "\x1F") == 0 || strcmp(c, "PING") == 0 || strcmp(c, "JOY:") == 0 || strcmp(c, "RAWJOY:") == 0 || strcmp(c, "JOG:") == 0)
+	if (strcmp(c, "\x1F") == 0 || strcmp(c, "PING") == 0 || strncmp(c, "JOY:", 4) == 0 || strncmp(c, "RAWJOY:", 7) == 0 || strncmp(c, "JOG:", 4) == 0)
 	{
 		m_bSpam = true;
 	}
@@ -95,6 +95,18 @@ void SerialEmulator::Print( const char *c )
 	}
 }
 
+// Sends binary data. It is not shown in the console
+void SerialEmulator::write( const uint8_t *data, int len )
+{
+	if (!WriteFile(m_ComPort, data, len, nullptr, &m_OvWrite))
+	{
+		if (GetLastError() == ERROR_IO_PENDING)
+		{
+			WaitForSingleObject(m_OvWrite.hEvent, 500);
+		}
+	}
+}
+
 void SerialEmulator::OutputConsole( const char *c )
 {
 	char buf[1024];
@@ -8,7 +8,8 @@ class SerialEmulator
 public:
 	void Init( HWND output );
 
-	void begin( int ) {}
+	void begin( unsigned long ) {}
+	void flush( void ) {}
 	void print( int i ) { char buf[100]; sprintf_s(buf, "%d", i); Print(buf); }
 	void print( unsigned int u ) { char buf[100]; sprintf_s(buf, "%u", u); Print(buf); } 
 	void print( float f ) { char buf[100]; sprintf_s(buf, "%.3f", f); Print(buf); }
@@ -19,7 +20,10 @@ public:
 	void println( float f ) { print(f); Print("\r\n"); }
 	void println( const char *c ) { print(c); Print("\r\n"); }
 
+	void write( const uint8_t *data, int len );
+
 	int16_t available( void );
+	int16_t availableForWrite( void ) { return 64; } // the writes don't block
 	char read( void );
 
 	void OutputConsole( const char *c );
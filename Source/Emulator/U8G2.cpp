@@ -22,6 +22,21 @@ void u8g2_t::drawXBMP( int x, int y, int w, int h, const BYTE *bitmap )
 	}
 }
 
+// Draws w columns of 8 pixels in the display's page layout (bit 0 is the top). Emulates the glyph blitter in Graphics.h
+void u8g2_t::drawColumns( int x, int y, int w, const BYTE *columns, char color )
+{
+	for (int xx = 0; xx < w; xx++)
+	{
+		if (xx + x < 0 || xx + x > 127) continue;
+		for (int yy = 0; yy < 8; yy++)
+		{
+			if (yy + y < 0 || yy + y > 63) continue;
+			char pix = (columns[xx] & (1 << yy)) != 0;
+			g_Screen[yy+y][xx+x] = color ? pix : !pix;
+		}
+	}
+}
+
 void u8g2_t::drawBox( int x, int y, int w, int h )
 {
 	char color = !m_ColorIndex;
@@ -41,6 +56,23 @@ void u8g2_t::sendBuffer( void )
 	memcpy(g_ScreenCopy, g_Screen, sizeof(g_Screen));
 }
 
+// Packs the 8x8 tile into 8 columns in the display's page layout, like the tiles in the u8g2 buffer
+void u8g2_t::getTile( int tx, int ty, BYTE tile[8] )
+{
+	for (int xx = 0; xx < 8; xx++)
+	{
+		BYTE column = 0;
+		for (int yy = 0; yy < 8; yy++)
+		{
+			if (g_Screen[ty * 8 + yy][tx * 8 + xx])
+			{
+				column |= 1 << yy;
+			}
+		}
+		tile[xx] = column;
+	}
+}
+
 #if U8G2_FULL_BUFFER
 void u8g2_t::updateDisplayArea( int tx, int ty, int tw, int th )
 {
@@ -11,10 +11,12 @@ public:
 	u8g2_t( void ) { m_bTransparent = false; m_ColorIndex = 0; }
 	void clearBuffer( void ) { memset(g_Screen, 0, sizeof(g_Screen)); }
 	void drawXBMP( int x, int y, int w, int h, const BYTE *bitmap );
+	void drawColumns( int x, int y, int w, const BYTE *columns, char color );
 	void drawBox( int x, int y, int w, int h );
 	void setBitmapMode( char transparent ) { m_bTransparent = (transparent != 0); }
 	void setDrawColor( char index ) { m_ColorIndex = !index; }
 	void sendBuffer( void );
+	void getTile( int tx, int ty, BYTE tile[8] );
 
 #if U8G2_FULL_BUFFER
 	void updateDisplayArea( int tx, int ty, int tw, int th );
@@ -39,6 +41,8 @@ inline void u8g2_ClearBuffer( u8g2_t *obj ) { obj->clearBuffer(); }
 inline void u8g2_SetDrawColor( u8g2_t *obj, char index ) { obj->setDrawColor(index); }
 inline void u8g2_DrawBox( u8g2_t *obj, int x, int y, int w, int h ) { obj->drawBox(x, y, w, h); }
 inline void u8g2_DrawXBMP( u8g2_t *obj, int x, int y, int w, int h, const BYTE *bitmap ) { obj->drawXBMP(x, y, w, h, bitmap); }
+inline void u8g2_GetTile( u8g2_t *obj, int tx, int ty, BYTE tile[8] ) { obj->getTile(tx, ty, tile); }
+inline void u8g2_DrawColumns( u8g2_t *obj, int x, int y, int w, const BYTE *columns, char color ) { obj->drawColumns(x, y, w, columns, color); }
 
 #define U8X8_PROGMEM
 #define U8G2_R0 0
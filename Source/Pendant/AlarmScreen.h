@@ -14,13 +14,17 @@ void AlarmScreen::Draw( void )
 	{
 		state = ((g_CurrentTime - m_DismissTime) / 200) % 3;
 	}
-	const bool bDrawButton = s_DrawState.bDrawAll || pDrawState->state != state;
+	const bool bDrawButton = IsRegionDirty(1 << BUTTON_DISMISS) || pDrawState->state != state;
 	pDrawState->state = state;
+	if (bDrawButton)
+	{
+		s_DrawState.dirtyRegions |= 1 << BUTTON_DISMISS; // so DrawButton doesn't skip it
+	}
 #else
 	const bool bDrawButton = true;
 #endif
 
-	if (s_DrawState.bDrawAll)
+	if (s_DrawState.bDrawAll || HasDirtyRegions())
 	{
 		DrawText(5, 0, ROMSTR("[Alarm]"));
 		DrawUnusedButtons(0x7F);
@@ -49,7 +53,7 @@ void AlarmScreen::Update( unsigned long time )
 	int8_t button = GetCurrentButton();
 	if (m_DismissTime == 0 && button == BUTTON_DISMISS)
 	{
-		Serial.println(ROMSTR("DISMISS"));
+		g_Port.println(ROMSTR("DISMISS"));
 		m_bDismissed = true;
 		m_DismissTime = time;
 	}
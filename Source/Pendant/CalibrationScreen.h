@@ -6,10 +6,10 @@ void CalibrationScreen::Draw( void )
 	DrawState *pDrawState = reinterpret_cast<DrawState*>(s_DrawState.custom);
 	const bool bDrawAll = s_DrawState.bDrawAll || pDrawState->stage != m_Stage;
 	pDrawState->stage = m_Stage;
-	if (!bDrawAll) return;
-	if (!s_DrawState.bDrawAll)
+	if (!bDrawAll && !HasDirtyRegions()) return;
+	if (bDrawAll && !s_DrawState.bDrawAll)
 	{
-		ClearBuffer();
+		RedrawAll();
 	}
 #endif
 
@@ -39,8 +39,8 @@ void CalibrationScreen::Update( unsigned long time )
 	int8_t button = GetCurrentButton();
 	if (button == BUTTON_OK)
 	{
-		Serial.print(g_StrCAL);
-		Serial.println(m_Stage);
+		g_Port.print(g_StrCAL);
+		g_Port.println(m_Stage);
 		m_Stage++;
 		if (m_Stage > DEADZONE_COUNT)
 		{
@@ -62,18 +62,15 @@ void CalibrationScreen::Activate( unsigned long time )
 
 void CalibrationScreen::Deactivate( void )
 {
-	Serial.print(g_StrCAL);
-	Serial.println(g_StrCANCEL);
+	g_Port.print(g_StrCAL);
+	g_Port.println(g_StrCANCEL);
 }
 
 void CalibrationScreen::SendXYUpdate( bool bForce )
 {
 	if (bForce || (m_OldJoyX != g_JoyX || m_OldJoyY != g_JoyY))
 	{
-		Serial.print(ROMSTR("RAWJOY:"));
-		Serial.print(g_JoyX);
-		Serial.print(g_StrComma);
-		Serial.println(g_JoyY);
+		g_Port.SendRawJoy(g_JoyX, g_JoyY);
 		m_OldJoyX = g_JoyX;
 		m_OldJoyY = g_JoyY;
 	}
@@ -10,6 +10,29 @@
 
 // USE_WATCHDOG - Set to 1 to enable the WDT crash detection
 
+// PENDANT_MAX_BAUD_RATE - The highest baud rate the PC can switch to after the handshake. The connection always starts at
+//                         PENDANT_BAUD_RATE (38400). Set to 38400 to disable the switch
+
+// USE_BINARY_PROTOCOL - Set to 1 to support the binary protocol (see Protocol.h). The PC will switch to it after the
+//                       handshake. Otherwise only the ASCII protocol is used
+
+// PENDANT_TX_QUEUE_SIZE - Size of the queue for messages to the PC, in bytes. The messages wait there while the Serial
+//                         transmit buffer is full, so the UI doesn't block. Must fit the longest message (64 bytes)
+
+// MAX_FRAME_RATE - The highest number of frames per second to draw. Frames are drawn only when something changes, and
+//                  the time between frames is used for the input and the serial port
+
+// SHADOW_SCREEN_BUFFER - Set to 1 to keep a copy of the last sent frame (1KB of RAM). The screens redraw everything
+//                       and only the tiles that differ from the copy are sent. Requires PARTIAL_SCREEN_UPDATE
+
+// BUILTIN_DISPLAY_DRIVER - Set to 1 to use the small SSD1309 driver in SSD1309.h instead of the u8g2 library. It sends
+//                          the buffer with larger I2C transmissions and uses less flash. Experimental - not measured on
+//                          the hardware yet, so u8g2 is the default
+
+// SCREEN_BENCHMARK - Set to 1 to send the drawing and I2C cost to the PC every 5 seconds (printed in the console as
+//                    #BENCH#), to compare SHADOW_SCREEN_BUFFER with the manual change tracking of the screens. It also
+//                    reports the frames drawn versus the loop iterations skipped by the frame rate limit
+
 // DISABLE_WELCOME_SCREEN, DISABLE_MACRO_SCREEN, DISABLE_CALIBRATION_SCREEN - disable individual screens to save memory
 //         (for experiments that need more memory)
 
@@ -20,12 +43,20 @@
 #define PARTIAL_SCREEN_UPDATE 0
 #define USE_NEW_ENCODER 0 // You can set to 1 (for example to test a new wheel hardware), but it will disable some other features to save memory
 #define USE_WATCHDOG 1
+#define USE_BINARY_PROTOCOL 0 // saves flash
+#define PENDANT_MAX_BAUD_RATE 38400
+#define PENDANT_TX_QUEUE_SIZE 72 // saves RAM
+#define MAX_FRAME_RATE 20 // drawing in pages is slow
+#define SHADOW_SCREEN_BUFFER 0
+#define BUILTIN_DISPLAY_DRIVER 0
 
 #if USE_NEW_ENCODER
 // Disable few of the non-essential screens to free up some memory for the NewEncoder library
 // To save even more memory, disable the macro U8G2_16BIT in U8g2\src\clib\u8g2.h
 #define DISABLE_WELCOME_SCREEN
+#if !BUILTIN_DISPLAY_DRIVER // the built-in driver leaves room for the macro screen
 #define DISABLE_MACRO_SCREEN
+#endif
 #define DISABLE_CALIBRATION_SCREEN
 #endif
 
@@ -35,6 +66,12 @@
 #define PARTIAL_SCREEN_UPDATE 1
 #define USE_NEW_ENCODER 1
 #define USE_WATCHDOG 1
+#define USE_BINARY_PROTOCOL 1
+#define PENDANT_MAX_BAUD_RATE 250000 // exact at 16MHz
+#define PENDANT_TX_QUEUE_SIZE 160
+#define MAX_FRAME_RATE 30
+#define SHADOW_SCREEN_BUFFER 0
+#define BUILTIN_DISPLAY_DRIVER 0
 
 #elif defined(__AVR_ATmega4808__) // Arduino Nano Every clone with ATmega4808
 
@@ -42,6 +79,12 @@
 #define PARTIAL_SCREEN_UPDATE 1
 #define USE_NEW_ENCODER 0 // NewEncoder doesn't recognize ATmega4808 out of the box. You need to modify interrupt_pins.h to get it to compile
 #define USE_WATCHDOG 1
+#define USE_BINARY_PROTOCOL 1
+#define PENDANT_MAX_BAUD_RATE 250000 // exact at 16MHz
+#define PENDANT_TX_QUEUE_SIZE 160
+#define MAX_FRAME_RATE 30
+#define SHADOW_SCREEN_BUFFER 0
+#define BUILTIN_DISPLAY_DRIVER 0
 
 #elif defined(ARDUINO_NANO_R4)
 
@@ -49,6 +92,12 @@
 #define PARTIAL_SCREEN_UPDATE 1
 #define USE_NEW_ENCODER 0 // NewEncoder doesn't recognize Nano R4 out of the box. The pins definitions are different
 #define USE_WATCHDOG 1
+#define USE_BINARY_PROTOCOL 1
+#define PENDANT_MAX_BAUD_RATE 1000000
+#define PENDANT_TX_QUEUE_SIZE 250
+#define MAX_FRAME_RATE 60
+#define SHADOW_SCREEN_BUFFER 1 // plenty of RAM
+#define BUILTIN_DISPLAY_DRIVER 0
 
 #elif defined(_WIN32) // Pendant emulator
 
@@ -56,11 +105,28 @@
 #define EMULATOR
 #define U8G2_FULL_BUFFER 1
 #define PARTIAL_SCREEN_UPDATE 1
+#define USE_BINARY_PROTOCOL 1
+#define PENDANT_MAX_BAUD_RATE 115200
+#define PENDANT_TX_QUEUE_SIZE 160
+#define MAX_FRAME_RATE 30
+#define SHADOW_SCREEN_BUFFER 0
+#define BUILTIN_DISPLAY_DRIVER 0 // the emulator has its own u8g2_t
 
 #else // Add support for more hardware here
 #error "Unknown microcontroller"
 #endif
 
+#define SCREEN_BENCHMARK 0
+
+#if !PARTIAL_SCREEN_UPDATE
+#undef SCREEN_BENCHMARK
+#define SCREEN_BENCHMARK 0 // only compares the partial update schemes
+#endif
+
 #if PARTIAL_SCREEN_UPDATE && !U8G2_FULL_BUFFER
 #error PARTIAL_SCREEN_UPDATE requires U8G2_FULL_BUFFER
 #endif
+
+#if SHADOW_SCREEN_BUFFER && !PARTIAL_SCREEN_UPDATE
+#error SHADOW_SCREEN_BUFFER requires PARTIAL_SCREEN_UPDATE
+#endif
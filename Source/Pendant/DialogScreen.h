@@ -23,10 +23,10 @@ void DialogScreen::Draw( void )
 	const bool bDrawAll = s_DrawState.bDrawAll || pDrawState->id != pState->m_Id || pDrawState->checkFlags != pState->m_CheckFlags;
 	pDrawState->id = pState->m_Id;
 	pDrawState->checkFlags = pState->m_CheckFlags;
-	if (!bDrawAll) return;
-	if (!s_DrawState.bDrawAll)
+	if (!bDrawAll && !HasDirtyRegions()) return;
+	if (bDrawAll && !s_DrawState.bDrawAll)
 	{
-		ClearBuffer();
+		RedrawAll();
 	}
 #endif
 
@@ -125,15 +125,16 @@ void DialogScreen::Deactivate( void )
 void DialogScreen::SendResponse( uint8_t button )
 {
 	auto *pState = GetActiveState();
-	Serial.print(ROMSTR("DIALOG:"));
-	Serial.print(pState->m_Id);
-	Serial.print(g_StrComma);
-	Serial.println(button);
+	g_Port.print(ROMSTR("DIALOG:"));
+	g_Port.print(pState->m_Id);
+	g_Port.print(g_StrComma);
+	g_Port.println(button);
 	pState->m_Id = 0;
 }
 
 // Parses the dialog description: <dialog id>|<title>|<line1>|<line2>|<line3>|<left button>,<right button>
-void DialogScreen::ParseDialog( const char *str )
+// The fields are already split at '|'
+void DialogScreen::ParseDialog( char **fields )
 {
 	auto *pState = GetActiveState();
 	pState->m_CheckFlags = 0;
@@ -143,12 +144,12 @@ void DialogScreen::ParseDialog( const char *str )
 	pState->m_ButtonDismissTimer = 0;
 
 	// parse id
-	pState->m_Id = atol(str);
-	str = strchr(str, '|') + 1;
+	pState->m_Id = atol(fields[0]);
 
 	// parse lines
 	for (uint8_t i = 0; i < 4; i++)
 	{
+		const char *str = fields[i + 1];
 		if (i > 0 && *str == '^')
 		{
 			pState->m_AlignFlags |= 1 << (i - 1);
@@ -159,17 +160,24 @@ void DialogScreen::ParseDialog( const char *str )
 			pState->m_CheckFlags |= 1 << (i - 1);
 			pState->m_AlignFlags |= 1 << (i - 1);
 		}
-		const char *end = strchr(str, '|');
-		uint8_t len = (uint8_t)(end - str);
+		uint8_t len = (uint8_t)Strlen(str);
 		if (len > 18) len = 18;
 		memcpy(pState->m_Lines[i], str, len);
 		pState->m_Lines[i][len] = 0;
-		str = end + 1;
 	}
 
 	// parse buttons
-	const char *end = strchr(str, ',');
-	uint8_t len = (uint8_t)(end - str);
+	const char *str = fields[5];
+	char *right = strchr(fields[5], ',');
+	if (right)
+	{
+		*right++ = 0;
+	}
+	else
+	{
+		right = fields[5] + Strlen(fields[5]); // no right button
+	}
+	uint8_t len = (uint8_t)Strlen(str);
 	if (*str == CHAR_HOLD)
 	{
 		pState->m_ButtonHoldFlags |= 1;
@@ -185,7 +193,7 @@ void DialogScreen::ParseDialog( const char *str )
 	if (len > MAX_BUTTON_SIZE) len = MAX_BUTTON_SIZE;
 	memcpy(pState->m_Buttons[0], str, len);
 	pState->m_Buttons[0][len] = 0;
-	str = end + 1;
+	str = right;
 
 	len = Strlen(str);
 	if (*str == '!')
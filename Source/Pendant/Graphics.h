@@ -4,7 +4,7 @@ u8g2_t u8g2;
 
 void InitializeGraphics( void )
 {
-#ifndef EMULATOR
+#if !defined(EMULATOR) && !BUILTIN_DISPLAY_DRIVER
 #if defined(ARDUINO_NANO_R4)
 	const u8x8_msg_cb &i2c = u8x8_byte_arduino_2nd_hw_i2c; // on Nano R4 use the second Wire interface for the Qwiic connector (ignore this if using regular I2C)
 #else
@@ -16,6 +16,8 @@ void InitializeGraphics( void )
 	u8g2_Setup_ssd1309_i2c_128x64_noname0_2(&u8g2, U8G2_R0, i2c, u8x8_gpio_and_delay_arduino);
 #endif
 	u8x8_SetPin_HW_I2C(u8g2_GetU8x8(&u8g2), U8X8_PIN_NONE, U8X8_PIN_NONE, U8X8_PIN_NONE);
+#endif
+#ifndef EMULATOR
 	u8g2_InitDisplay(&u8g2);
 	u8g2_ClearDisplay(&u8g2);
 	u8g2_SetPowerSave(&u8g2, 0);
@@ -25,31 +27,155 @@ void InitializeGraphics( void )
 // Y position for each row of text. Leaves a larger gap between first and second row for the title
 const int8_t g_Rows[5] = {0, 16, 29, 42, 55};
 
+#if U8G2_FULL_BUFFER
+bool IsAreaVisible( int16_t y, int16_t h )
+{
+	return true;
+}
+#else
+// In page mode the screen is drawn in horizontal strips of a few pages, running Draw once for each strip. Returns true
+// if the rows y..y+h-1 overlap the current strip. Anything else can be skipped, including the formatting of its text
+bool IsAreaVisible( int16_t y, int16_t h )
+{
+	const int16_t top = u8g2_GetBufferCurrTileRow(&u8g2) * 8;
+	return y < top + u8g2_GetBufferTileHeight(&u8g2) * 8 && y + h > top;
+}
+#endif
+
+// Returns true if the text row (including the box around it) is in the current strip
+bool IsRowVisible( uint8_t row )
+{
+	return IsAreaVisible(g_Rows[row] - 1, 10);
+}
+
+// Incremented by everything that can change what is on the screen - commands from the PC, input and screen changes.
+// A new frame is drawn only when it differs from the last drawn one (or when it's time for a periodic refresh)
+uint8_t g_StateGeneration;
+
+void StateChanged( void )
+{
+	g_StateGeneration++;
+}
+
 #if PARTIAL_SCREEN_UPDATE
-uint8_t g_DirtyRect[4]; // x1, y1, x2, y2 (in pixels)
+// The modified 8x8 tiles of the screen, matching the 8-pixel pages of the display. One word per page, one bit per column
+uint16_t g_DirtyTiles[8];
 
-void ClearDirtyRect( void )
+uint16_t g_FlushTiles[8]; // the tiles of the previous frame that still need to be sent
+uint8_t g_FlushPage = 8; // the first page with tiles to send. 8 when done
+
+#if BUILTIN_DISPLAY_DRIVER
+const uint8_t TILE_RUN_OVERHEAD = 8; // I2C bytes to start sending a run of tiles (device address, addressing commands and control bytes)
+#else
+const uint8_t TILE_RUN_OVERHEAD = 10; // approximate I2C bytes to start sending a run of tiles (addressing commands)
+#endif
+const uint16_t FULL_SCREEN_COST = 8 * (TILE_RUN_OVERHEAD + 128); // the whole buffer is sent as one run per page
+const uint8_t FLUSH_TILES_PER_STEP = 32; // how many tiles to send per loop iteration (about 7ms at 400kHz)
+
+#if SCREEN_BENCHMARK
+uint16_t g_BenchTiles; // tiles sent since the last report
+uint16_t g_BenchRuns; // runs of tiles sent since the last report
+uint16_t g_BenchDrawCalls; // boxes and texts drawn since the last report
+#endif
+
+#if SHADOW_SCREEN_BUFFER
+uint8_t g_ShadowBuffer[8][128]; // copy of the display contents, in the u8g2 buffer layout
+
+// Compares the buffer with the shadow copy and marks the tiles that differ as dirty. Replaces the tiles marked by the
+// drawing functions, so the screens don't need to track their changes
+void DiffShadowBuffer( void )
 {
-	g_DirtyRect[0] = 128;
-	g_DirtyRect[1] = 64;
-	g_DirtyRect[2] = g_DirtyRect[3] = 0;
+	for (uint8_t page = 0; page < 8; page++)
+	{
+		uint16_t bits = 0;
+		for (uint8_t tx = 0; tx < 16; tx++)
+		{
+#ifdef EMULATOR
+			uint8_t tile[8];
+			u8g2_GetTile(&u8g2, tx, page, tile);
+#else
+			const uint8_t *tile = u8g2_GetBufferPtr(&u8g2) + page * 128 + tx * 8;
+#endif
+			uint8_t *shadow = &g_ShadowBuffer[page][tx * 8];
+			if (memcmp(tile, shadow, 8) != 0)
+			{
+				memcpy(shadow, tile, 8);
+				bits |= 1u << tx;
+			}
+		}
+		g_DirtyTiles[page] = bits;
+	}
 }
+#endif
 
-void UpdateDirtyRect( void )
+// Starts sending the modified tiles. They are sent in small steps by FlushTiles, so the buffer must not change until
+// it's done
+void BeginFlush( void )
 {
-	if (g_DirtyRect[0] == 0 && g_DirtyRect[1] == 0 && g_DirtyRect[2] == 128 && g_DirtyRect[3] == 64)
+	// join the runs separated by gaps that are cheaper to send than to start a new run, and add up the cost
+	uint16_t cost = 0;
+	for (uint8_t page = 0; page < 8; page++)
 	{
-		u8g2_SendBuffer(&u8g2);
+		uint16_t bits = g_DirtyTiles[page];
+		int8_t end = -1; // the last tile of the previous run
+		for (int8_t tx = 0; tx < 16; tx++)
+		{
+			if (bits & (1u << tx))
+			{
+				uint8_t gap = tx - end - 1;
+				if (end >= 0 && gap * 8 < TILE_RUN_OVERHEAD)
+				{
+					bits |= ((1u << gap) - 1) << (end + 1);
+					cost += gap * 8;
+				}
+				else
+				{
+					cost += TILE_RUN_OVERHEAD;
+				}
+				cost += 8;
+				end = tx;
+			}
+		}
+		g_FlushTiles[page] = bits;
 	}
-	else if (g_DirtyRect[0] < g_DirtyRect[2])
+
+	if (cost >= FULL_SCREEN_COST)
 	{
-		int8_t tx1 = g_DirtyRect[0] / 8;
-		int8_t ty1 = g_DirtyRect[1] / 8;
-		int8_t tx2 = (g_DirtyRect[2] + 7) / 8;
-		int8_t ty2 = (g_DirtyRect[3] + 7) / 8;
-		u8g2_UpdateDisplayArea(&u8g2, tx1, ty1, tx2 - tx1, ty2 - ty1);
+		memset(g_FlushTiles, 0xFF, sizeof(g_FlushTiles)); // send whole pages
 	}
-	ClearDirtyRect();
+	memset(g_DirtyTiles, 0, sizeof(g_DirtyTiles));
+	g_FlushPage = 0;
+}
+
+// Sends the next FLUSH_TILES_PER_STEP tiles. Returns true if everything is sent
+bool FlushTiles( void )
+{
+	uint8_t budget = FLUSH_TILES_PER_STEP;
+	for (; g_FlushPage < 8; g_FlushPage++)
+	{
+		uint16_t bits = g_FlushTiles[g_FlushPage];
+		while (bits)
+		{
+			if (budget == 0)
+			{
+				g_FlushTiles[g_FlushPage] = bits;
+				return false;
+			}
+			uint8_t tx = 0;
+			while (!(bits & (1u << tx))) tx++;
+			uint8_t len = 0;
+			while (tx + len < 16 && (bits & (1u << (tx + len))) && len < budget) len++;
+			u8g2_UpdateDisplayArea(&u8g2, tx, g_FlushPage, len, 1);
+#if SCREEN_BENCHMARK
+			g_BenchTiles += len;
+			g_BenchRuns++;
+#endif
+			bits &= ~(uint16_t)(((1ul << len) - 1) << tx);
+			budget -= len;
+		}
+		g_FlushTiles[g_FlushPage] = 0;
+	}
+	return true;
 }
 
 void InvalidateRect( int16_t x, int16_t y, int16_t w, int16_t h )
@@ -62,23 +188,59 @@ void InvalidateRect( int16_t x, int16_t y, int16_t w, int16_t h )
 	if (y2 > 64) y2 = 64;
 	if (x < x2 && y < y2)
 	{
-		if (g_DirtyRect[0] > x) g_DirtyRect[0] = x;
-		if (g_DirtyRect[1] > y) g_DirtyRect[1] = y;
-		if (g_DirtyRect[2] < x2) g_DirtyRect[2] = x2;
-		if (g_DirtyRect[3] < y2) g_DirtyRect[3] = y2;
+		uint16_t mask = (0xFFFFu << (x / 8)) & (0xFFFFu >> (15 - (x2 - 1) / 8));
+		for (uint8_t page = y / 8; page <= (y2 - 1) / 8; page++)
+		{
+			g_DirtyTiles[page] |= mask;
+		}
 	}
 }
 
 void InvalidateRect( void )
 {
-	g_DirtyRect[0] = g_DirtyRect[1] = 0;
-	g_DirtyRect[2] = 128;
-	g_DirtyRect[3] = 64;
+	memset(g_DirtyTiles, 0xFF, sizeof(g_DirtyTiles));
 }
 
-bool IsDirtyPixel( int16_t x, int16_t y )
+// Glyph cache - remembers the glyph drawn in each text cell (col * 7 + 1, g_Rows[row]), so DrawTextInt can skip the
+// ones that haven't changed. Each entry is the font index + draw color in bit 7, or 0 if unknown. Anything else drawn
+// over a cell clears its entry
+const uint8_t GLYPH_COLS = 18;
+const uint8_t GLYPH_ROWS = 5;
+uint8_t g_GlyphCache[GLYPH_ROWS][GLYPH_COLS];
+
+// Returns the cache entry for the text cell at the given position, or NULL if it's not on the text grid
+uint8_t *GetGlyphCache( int8_t x, int8_t y )
 {
-	return x >= g_DirtyRect[0] && x < g_DirtyRect[2] && y >= g_DirtyRect[1] && y < g_DirtyRect[3];
+	if (x < 1 || (x - 1) % 7 != 0 || (x - 1) / 7 >= GLYPH_COLS)
+	{
+		return NULL;
+	}
+	for (uint8_t row = 0; row < GLYPH_ROWS; row++)
+	{
+		if (g_Rows[row] == y)
+		{
+			return &g_GlyphCache[row][(x - 1) / 7];
+		}
+	}
+	return NULL;
+}
+
+// Clears the cache entries for all cells that overlap the rectangle
+void InvalidateGlyphs( int16_t x, int16_t y, int16_t w, int16_t h )
+{
+	for (uint8_t row = 0; row < GLYPH_ROWS; row++)
+	{
+		if (g_Rows[row] + 9 > y && g_Rows[row] < y + h) // lowercase letters go 1 pixel lower
+		{
+			for (uint8_t col = 0; col < GLYPH_COLS; col++)
+			{
+				if (col * 7 + 8 > x && col * 7 + 1 < x + w)
+				{
+					g_GlyphCache[row][col] = 0;
+				}
+			}
+		}
+	}
 }
 #endif
 
@@ -88,26 +250,95 @@ void ClearBuffer( void )
 	u8g2_ClearBuffer(&u8g2);
 #if PARTIAL_SCREEN_UPDATE
 	InvalidateRect();
+	memset(g_GlyphCache, 0, sizeof(g_GlyphCache));
 #endif
 }
 #endif
 
+uint8_t g_DrawColor = 1;
+
 void SetDrawColor( uint8_t color )
 {
 	u8g2_SetDrawColor(&u8g2, color);
+	g_DrawColor = color;
 }
 
 void DrawBox( uint8_t x, uint8_t y, uint8_t w, uint8_t h )
 {
+	if (!IsAreaVisible(y, h))
+	{
+		return;
+	}
+#if SCREEN_BENCHMARK
+	g_BenchDrawCalls++;
+#endif
 	u8g2_DrawBox(&u8g2, x, y, w, h);
 #if PARTIAL_SCREEN_UPDATE
 	InvalidateRect(x, y, w, h);
+	InvalidateGlyphs(x, y, w, h);
 #endif
 }
 
-void DrawTextInt( int8_t x, int8_t y, const char *text, bool bBold, bool bRomStr )
+// Draws a glyph from g_Font straight into the u8g2 tile buffer. The font is stored as 7 columns in the display's page
+// layout followed by the vertical offset, so each column is 1 or 2 masked byte writes. The result is the same as
+// u8g2_DrawXBMP in solid mode - the foreground gets the draw color and the background gets the opposite. The columns
+// past the right edge are clipped, and a glyph that starts outside the screen is skipped
+void DrawGlyph( int16_t x, int8_t y, const uint8_t *glyph )
 {
-	int8_t x0 = x;
+	if (x < 0 || x >= 128)
+	{
+		return;
+	}
+#ifdef EMULATOR
+	u8g2_DrawColumns(&u8g2, x, y + glyph[7], 7, glyph, g_DrawColor);
+#else
+	y += pgm_read_byte(glyph + 7);
+	const uint8_t invert = g_DrawColor ? 0 : 0xFF;
+	const int8_t pages = u8g2_GetBufferTileHeight(&u8g2);
+	const int8_t page = (y >> 3) - u8g2_GetBufferCurrTileRow(&u8g2); // the buffer has only some of the pages in page mode
+	const uint8_t shift = y & 7;
+	uint8_t *buf = u8g2_GetBufferPtr(&u8g2);
+	uint8_t *dst1 = (page >= 0 && page < pages) ? buf + page * 128 + x : NULL;
+	uint8_t *dst2 = (shift != 0 && page + 1 >= 0 && page + 1 < pages) ? buf + (page + 1) * 128 + x : NULL;
+	uint8_t count = x > 128 - 7 ? 128 - x : 7;
+
+	if (shift == 0)
+	{
+		// aligned to a page - copy the columns
+		if (dst1)
+		{
+			for (uint8_t i = 0; i < count; i++)
+			{
+				dst1[i] = pgm_read_byte(glyph + i) ^ invert;
+			}
+		}
+		return;
+	}
+
+	const uint8_t mask1 = 0xFF << shift;
+	const uint8_t mask2 = 0xFF >> (8 - shift);
+	for (uint8_t i = 0; i < count; i++)
+	{
+		uint8_t col = pgm_read_byte(glyph + i) ^ invert;
+		if (dst1) dst1[i] = (dst1[i] & ~mask1) | (uint8_t)(col << shift);
+		if (dst2) dst2[i] = (dst2[i] & ~mask2) | (col >> (8 - shift));
+	}
+#endif
+}
+
+void DrawTextInt( int16_t x, int8_t y, const char *text, bool bBold, bool bRomStr )
+{
+	if (!IsAreaVisible(y, 9)) // lowercase letters go 1 pixel lower
+	{
+		return;
+	}
+#if SCREEN_BENCHMARK
+	g_BenchDrawCalls++;
+#endif
+#if PARTIAL_SCREEN_UPDATE
+	uint8_t *pCache = GetGlyphCache((int8_t)x, y);
+	uint8_t *pCacheEnd = pCache ? pCache - (x - 1) / 7 + GLYPH_COLS : NULL;
+#endif
 	for (;; text++, x+= 7)
 	{
 #ifdef EMULATOR
@@ -115,7 +346,7 @@ void DrawTextInt( int8_t x, int8_t y, const char *text, bool bBold, bool bRomStr
 #else
 		char c = bRomStr ? pgm_read_byte(text) : *text;
 #endif
-		if (c == 0) break;
+		if (c == 0 || x >= 128) break; // the rest of the text is past the right edge
 		uint8_t idx = c;
 		if (idx < sizeof(g_Font)/8)
 		{
@@ -123,13 +354,36 @@ void DrawTextInt( int8_t x, int8_t y, const char *text, bool bBold, bool bRomStr
 			{
 				if (c >= '0' && c <= '9') idx -= 32;
 			}
-			u8g2_DrawXBMP(&u8g2, x, (c >= 'a' && c <= 'z') ? y + 1 : y, 7, 8, g_Font +idx*8);
+			const uint8_t *glyph = g_Font + idx*8;
+#if PARTIAL_SCREEN_UPDATE
+#ifdef EMULATOR
+			int8_t gy = y + glyph[7];
+#else
+			int8_t gy = y + pgm_read_byte(glyph + 7);
+#endif
+			if (pCache && pCache < pCacheEnd)
+			{
+				// only draw the cells that changed
+				uint8_t cached = idx | (g_DrawColor << 7);
+				if (*pCache == cached)
+				{
+					pCache++;
+					continue;
+				}
+				*pCache = cached;
+			}
+			else
+			{
+				InvalidateGlyphs(x, gy, 7, 8);
+			}
+			InvalidateRect(x, gy, 7, 8);
+#endif
+			DrawGlyph(x, y, glyph);
 		}
-	}
-
 #if PARTIAL_SCREEN_UPDATE
-	InvalidateRect(x0, y, x - x0, 8);
+		if (pCache) pCache++;
 #endif
+	}
 }
 
 void DrawTextXY( int8_t x, int8_t y, const char *text )
@@ -10,6 +10,29 @@ const int JOYSTICK_STEPS = 100; // number of steps in the joystick range
 #endif
 
 const uint16_t BUTTON_HOLD_TIME = 1000; // hold for 1 second
+const uint8_t BUTTON_DEBOUNCE_SAMPLES = 8; // a button changes state after 8 more samples (1ms apart) agree than disagree
+
+const uint8_t JOYSTICK_FILTER_SHIFT = 4; // each joystick sample moves the filtered value by 1/16 of the difference
+
+#if defined(__AVR_ATmega328P__)
+
+typedef uint8_t PinRegisterType;
+const uint8_t JOYSTICK_ADC_BITS = 10;
+typedef uint16_t JoyFilterType;
+
+#elif defined(__AVR_ATmega4808__) || defined(__AVR_ATmega4809__)
+
+typedef uint8_t PinRegisterType;
+const uint8_t JOYSTICK_ADC_BITS = 12; // the ADC accumulates 4 samples of 10 bits
+typedef uint16_t JoyFilterType;
+
+#elif defined(ARDUINO_NANO_R4)
+
+typedef uint16_t PinRegisterType;
+const uint8_t JOYSTICK_ADC_BITS = 14;
+typedef uint32_t JoyFilterType;
+
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////
 // Buttons
@@ -26,20 +49,63 @@ bool TestBit( uint16_t flags, uint8_t bit )
 	return (flags & (1 << bit)) != 0;
 }
 
-void UpdateButtonState( uint16_t physicalState, uint16_t dt )
+#ifndef EMULATOR
+// The buttons are sampled by a 1kHz timer interrupt (see ReadButtons). Each button has an integrator that counts
+// towards its raw state, and the debounced state flips only when the integrator reaches the end of its range. Every
+// flip is counted, so the loop can replay the presses and releases in order, no matter how long a frame takes
+uint8_t g_ButtonIntegrators[BUTTON_COUNT];
+volatile uint16_t g_DebouncedButtons;
+volatile uint8_t g_ButtonEdges[BUTTON_COUNT]; // debounced changes of each button, incremented by the interrupt
+uint8_t g_ButtonEdgesSeen[BUTTON_COUNT]; // the changes already returned by GetButtonSnapshot
+
+// Called from the timer interrupt with the raw state of the buttons
+void ScanButtons( uint16_t raw )
 {
-	// debounce - ignore state change within 10 ms since the last one
-	uint16_t changed = g_ButtonState ^ physicalState;
-	for (int i = 0; i < BUTTON_COUNT; i++)
+	uint16_t state = g_DebouncedButtons;
+	for (uint8_t i = 0; i < BUTTON_COUNT; i++)
 	{
-		uint16_t mask = 1 << i;
-		if ((changed & mask) && g_ButtonChangeTimers[i] < 10)
+		uint8_t &integrator = g_ButtonIntegrators[i];
+		const uint16_t mask = 1 << i;
+		if (raw & mask)
 		{
-			physicalState ^= mask;
+			if (integrator < BUTTON_DEBOUNCE_SAMPLES && ++integrator == BUTTON_DEBOUNCE_SAMPLES)
+			{
+				state |= mask;
+				g_ButtonEdges[i]++;
+			}
+		}
+		else if (integrator > 0 && --integrator == 0)
+		{
+			state &= ~mask;
+			g_ButtonEdges[i]++;
+		}
+	}
+	g_DebouncedButtons = state;
+}
+
+// Returns the debounced buttons, applying at most one press or release of each button since the previous call. A
+// release and a re-press during a long frame are returned on two consecutive frames instead of being merged into one
+// held press, so UpdateButtonState sees every click
+uint16_t GetButtonSnapshot( void )
+{
+	uint16_t buttons = g_ButtonState;
+	for (uint8_t i = 0; i < BUTTON_COUNT; i++)
+	{
+		if (g_ButtonEdges[i] != g_ButtonEdgesSeen[i]) // a single byte, so the read is atomic
+		{
+			g_ButtonEdgesSeen[i]++;
+			buttons ^= 1 << i;
 		}
 	}
+	return buttons;
+}
+#endif
 
-	changed = g_ButtonState ^ physicalState;
+// Updates the clicks, holds and timers from the debounced state of the buttons
+void UpdateButtonState( uint16_t physicalState, uint16_t dt )
+{
+	const uint16_t changed = g_ButtonState ^ physicalState;
+	const uint16_t oldDown = g_ButtonDown;
 	g_ButtonClick = physicalState & ~g_ButtonState;
 	g_ButtonUnclick = ~physicalState & g_ButtonState;
 	g_ButtonState = physicalState;
@@ -72,6 +138,11 @@ void UpdateButtonState( uint16_t physicalState, uint16_t dt )
 			g_ButtonDown |= mask;
 		}
 	}
+
+	if (changed || g_ButtonHold || g_ButtonDown != oldDown)
+	{
+		StateChanged();
+	}
 }
 
 void ReleaseAllButtons( void )
@@ -93,30 +164,112 @@ void ReleaseAllButtons( void )
 uint16_t g_JoyX = 512;
 uint16_t g_JoyY = 512;
 
+#ifndef EMULATOR
+// The ADC samples X and Y in the background (see StartJoystickADC). Each sample goes through an IIR filter, so the loop
+// only picks up the latest filtered values. The filter state is the value scaled by 2^JOYSTICK_FILTER_SHIFT
+volatile JoyFilterType g_JoyFilters[2] = {(JoyFilterType)1 << (JOYSTICK_ADC_BITS - 1 + JOYSTICK_FILTER_SHIFT), (JoyFilterType)1 << (JOYSTICK_ADC_BITS - 1 + JOYSTICK_FILTER_SHIFT)};
+#if !defined(ARDUINO_NANO_R4)
+uint8_t g_JoyAdcAxis; // the axis being converted - 0 for X, 1 for Y
+#endif
+
+// Called from the ADC interrupt with a sample of JOYSTICK_ADC_BITS for the given axis
+void FilterJoystick( uint8_t axis, uint16_t sample )
+{
+	const JoyFilterType filter = g_JoyFilters[axis];
+	g_JoyFilters[axis] = filter - (filter >> JOYSTICK_FILTER_SHIFT) + sample;
+}
+#endif
+
 void UpdateJoystick()
 {
 #ifndef EMULATOR
-	g_JoyX = 1023 - analogRead(g_JoyPinX);
-	g_JoyY = 1023 - analogRead(g_JoyPinY);
+	noInterrupts();
+	const JoyFilterType x = g_JoyFilters[0];
+	const JoyFilterType y = g_JoyFilters[1];
+	interrupts();
+
+	// the calibration is in 10 bits, so the extra bits only reduce the noise
+	const uint8_t shift = JOYSTICK_ADC_BITS - 10 + JOYSTICK_FILTER_SHIFT;
+	const JoyFilterType round = (JoyFilterType)1 << (shift - 1);
+	g_JoyX = 1023 - (uint16_t)((x + round) >> shift < 1023 ? (x + round) >> shift : 1023);
+	g_JoyY = 1023 - (uint16_t)((y + round) >> shift < 1023 ? (y + round) >> shift : 1023);
 #endif
 }
 
-// Quantizes the raw joystick position to range [-JOYSTICK_STEPS..JOYSTICK_STEPS] based on the calibration settings
-int8_t QuantizeJoystick( uint16_t val, const uint16_t calibration[4] )
+// The response curve is baked into a table of steps, and the calibration of each side of each axis into a scale that
+// converts the distance from the center zone to a position on the curve. The table starts at the edge of the center
+// zone, so the interpolation never crosses the center. Quantizing a position takes a multiplication, a lookup and a
+// linear interpolation between two entries, with no divisions
+struct JoystickAxis
+{
+	uint16_t centerMin, centerMax; // the center zone, where the joystick is released
+	uint16_t scaleMin, scaleMax; // curve segments per raw value in 1/65536, below and above the center zone
+};
+
+JoystickAxis g_JoyAxes[2]; // X and Y
+uint8_t g_JoyCurveSteps[JOYSTICK_CURVE_POINTS + 1]; // the curve in steps, starting with 0 at the edge of the center zone
+
+// Returns the scale for one side of the center zone, which is length raw values long
+uint16_t GetJoystickScale( uint16_t length )
+{
+	const uint32_t scale = ((uint32_t)JOYSTICK_CURVE_POINTS << 16) / length;
+	return scale < 0xFFFF ? scale : 0xFFFF;
+}
+
+// Rebuilds the joystick table and scales after the calibration or the curve changes
+// calibration: <min>,<min center>,<max center>,<max> for X, then for Y
+void UpdateJoystickTables( void )
 {
-	if (val < calibration[1])
+	g_JoyCurveSteps[0] = 0;
+	for (uint8_t i = 0; i < JOYSTICK_CURVE_POINTS; i++)
 	{
-		int8_t res = - 1 - ((calibration[1] - val - 1) * JOYSTICK_STEPS) / (calibration[1] - calibration[0]);
-		return res > -JOYSTICK_STEPS ? res : -JOYSTICK_STEPS;
+		g_JoyCurveSteps[i + 1] = g_RomSettings.joyCurve[i] * JOYSTICK_STEPS / 100;
 	}
 
-	if (val > calibration[2])
+	for (uint8_t i = 0; i < 2; i++)
 	{
-		int8_t res = 1 + (val - calibration[2] - 1) * JOYSTICK_STEPS / (calibration[3] - calibration[2]);
-		return res < JOYSTICK_STEPS ? res : JOYSTICK_STEPS;
+		const uint16_t *calibration = g_RomSettings.calibration + i * 4;
+		JoystickAxis &axis = g_JoyAxes[i];
+		axis.centerMin = calibration[1];
+		axis.centerMax = calibration[2];
+		axis.scaleMin = GetJoystickScale(calibration[1] - calibration[0]);
+		axis.scaleMax = GetJoystickScale(calibration[3] - calibration[2]);
 	}
+}
 
-	return 0;
+// Quantizes the raw joystick position to range [-JOYSTICK_STEPS..JOYSTICK_STEPS] based on the calibration settings
+int8_t QuantizeJoystick( uint16_t val, const JoystickAxis &axis )
+{
+	uint16_t dist, scale;
+	if (val < axis.centerMin)
+	{
+		dist = axis.centerMin - val;
+		scale = axis.scaleMin;
+	}
+	else if (val > axis.centerMax)
+	{
+		dist = val - axis.centerMax;
+		scale = axis.scaleMax;
+	}
+	else
+	{
+		return 0;
+	}
+
+	const uint32_t pos = ((uint32_t)dist * scale) >> 8; // position on the curve in 1/256 of a segment
+	int8_t res = JOYSTICK_STEPS;
+	if (pos < (uint16_t)JOYSTICK_CURVE_POINTS << 8)
+	{
+		const uint8_t seg = pos >> 8;
+		const int16_t a = g_JoyCurveSteps[seg];
+		const int16_t b = g_JoyCurveSteps[seg + 1];
+		res = a + (((b - a) * (uint8_t)pos) >> 8);
+		if (res == 0)
+		{
+			res = 1; // outside the center zone always move a little
+		}
+	}
+	return val < axis.centerMin ? -res : res;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -139,6 +292,10 @@ int16_t EncoderDrainValue( void )
 {
 	int16_t val = g_EncoderValue;
 	g_EncoderValue = 0;
+	if (val != 0)
+	{
+		StateChanged();
+	}
 	return val;
 }
 
@@ -170,6 +327,7 @@ public:
 				noInterrupts();
 				liveState.currentValue -= delta * 2;
 				interrupts();
+				StateChanged();
 				return delta;
 			}
 		}
@@ -193,16 +351,6 @@ int16_t EncoderDrainValue( void )
 
 #else
 
-#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega4808__) || defined(__AVR_ATmega4809__)
-
-typedef uint8_t PinRegisterType;
-
-#elif defined(ARDUINO_NANO_R4)
-
-typedef uint16_t PinRegisterType;
-
-#endif
-
 #define NE_STATE_MASK 0b00000111
 #define NE_DELTA_MASK 0b00011000
 #define NE_INCREMENT_DELTA 0b00001000
@@ -347,6 +495,7 @@ int16_t EncoderDrainValue( void )
 			noInterrupts();
 			g_EncoderLiveState.currentValue -= delta * 2;
 			interrupts();
+			StateChanged();
 			return delta;
 		}
 	}
@@ -1,8 +1,13 @@
 const int WHEEL_UPDATE_TIME = 100; // don't send wheel updates more than once every 100ms
 const int JOYSTICK_UPDATE_TIME = 100; // don't send joystick updates more than once every 100ms
+const int WHEEL_STOP_TIME = 250; // in the MPG mode the jog stops 250ms after the last click
+const int WHEEL_MAX_SAMPLE_TIME = 500; // the first clicks after a stop are counted over at most 500ms
 
 const char g_AxisName[5] = {' ', 'X', 'Y', ' ', 'Z'};
 
+DEFINE_STRING(g_StrStep, "Step");
+DEFINE_STRING(g_StrMPG, "MPG ");
+
 #if USE_SHARED_STATE
 JogScreen::ActiveState *JogScreen::GetActiveState( void )
 {
@@ -17,8 +22,11 @@ void JogScreen::SetAxis( uint8_t axis )
 	uint8_t old = pState->m_Axis;
 	if (old == 3 && axis != 3)
 	{
-		Serial.print(g_StrJOG2);
-		Serial.println(ROMSTR("JXY0,0"));
+		g_Port.SendRealtime(REALTIME_JOG_CANCEL);
+	}
+	if (pState->m_WheelSpeed != 0 && axis != old)
+	{
+		SendWheelSpeed(0); // stop the MPG jog along the old axis
 	}
 	pState->m_Axis = axis;
 }
@@ -28,150 +36,82 @@ JogScreen::JogScreen( void )
 	m_StepRateCount = 2;
 	m_StepRates[0] = 10;
 	m_StepRates[1] = 100;
+	m_AccelPointCount = 0;
 }
 
+const WidgetLayout JogScreen::s_Layout[WIDGET_COUNT] PROGMEM =
+{
+	{WIDGET_STATUS, 0, 0},
+	{WIDGET_LABEL, 13, 1},
+	{WIDGET_COORD, 2, 1},
+	{WIDGET_COORD, 2, 2},
+	{WIDGET_COORD, 2, 3},
+	{WIDGET_BUTTON, BUTTON_STEP, 0},
+	{WIDGET_BUTTON, BUTTON_GOTO0, 0},
+	{WIDGET_BUTTON, BUTTON_SET0, 0},
+	{WIDGET_BUTTON, BUTTON_BACK, 0},
+};
+
 void JogScreen::Draw( void )
 {
 	auto *pState = GetActiveState();
 
-#if PARTIAL_SCREEN_UPDATE
-	DrawState *pDrawState = reinterpret_cast<DrawState*>(s_DrawState.custom);
-	const bool bDrawAll = s_DrawState.bDrawAll || pDrawState->bWorkSpace != g_bWorkSpace ||
-		pDrawState->bShowInches != g_bShowInches || pDrawState->axis != pState->m_Axis ||
-		pDrawState->bShowStop != pState->m_bShowStop || pDrawState->bShowActions != pState->m_bShowActions ||
-		pDrawState->bShowAlign != pState->m_bShowAlign || pDrawState->stepIndex != m_StepIndex;
-	pDrawState->bWorkSpace = g_bWorkSpace;
-	pDrawState->bShowInches = g_bShowInches;
-	pDrawState->axis = pState->m_Axis;
-	pDrawState->bShowStop = pState->m_bShowStop;
-	pDrawState->bShowActions = pState->m_bShowActions;
-	pDrawState->bShowAlign = pState->m_bShowAlign;
-	pDrawState->stepIndex = m_StepIndex;
-	if (bDrawAll && !s_DrawState.bDrawAll)
-	{
-		ClearBuffer();
-	}
+	SetText(WIDGET_STATUS_LINE, g_StrJOG, 3);
+	SetText(WIDGET_WCS, g_bWorkSpace ? g_StrWCS : g_StrMCS, 5);
+	SetCoord(WIDGET_X, (pState->m_Axis & 1) ? g_StrBoldX : g_StrX, GetDisplayX(), (pState->m_Axis & 1) != 0);
+	SetCoord(WIDGET_Y, (pState->m_Axis & 2) ? g_StrBoldY : g_StrY, GetDisplayY(), (pState->m_Axis & 2) != 0);
+	SetCoord(WIDGET_Z, (pState->m_Axis & 4) ? g_StrBoldZ : g_StrZ, GetDisplayZ(), (pState->m_Axis & 4) != 0);
 
-	const bool bDrawX = bDrawAll || pDrawState->wx != g_WorkX || pDrawState->ox != g_OffsetX;
-	const bool bDrawY = bDrawAll || pDrawState->wy != g_WorkY || pDrawState->oy != g_OffsetY;
-	const bool bDrawZ = bDrawAll || pDrawState->wz != g_WorkZ || pDrawState->oz != g_OffsetZ;
-	pDrawState->wx = g_WorkX;
-	pDrawState->ox = g_OffsetX;
-	pDrawState->wy = g_WorkY;
-	pDrawState->oy = g_OffsetY;
-	pDrawState->wz = g_WorkZ;
-	pDrawState->oz = g_OffsetZ;
-#else
-	const bool bDrawX = true, bDrawY = true, bDrawZ = true, bDrawAll = true;
-#endif
-
-	if (bDrawAll)
+	if ((pState->m_Axis & (pState->m_Axis-1)) == 0)
 	{
-		DrawMachineStatus(g_StrJOG, 3);
-		DrawText(13, 1, g_bWorkSpace ? g_StrWCS : g_StrMCS);
-		if ((pState->m_Axis & (pState->m_Axis-1)) == 0)
+		// only one axis is selected
+		if (pState->m_bShowAlign)
+		{
+			SetText(WIDGET_STEP, ROMSTR("Align"), 5, true);
+		}
+		else if (IsButtonVisible(BUTTON_STEP))
 		{
-			// only one axis is selected
 			uint16_t step = m_StepRates[m_StepIndex];
-			if (pState->m_bShowAlign)
+			int8_t len = g_bShowInches ? Sprintf(g_TextBuf, "     %1d.%03d", step/1000, step%1000) : Sprintf(g_TextBuf, "     %2d.%02d", step/100, step%100);
+			memcpy_P(g_TextBuf, (const char*)(m_bWheelSpeedMode ? g_StrMPG : g_StrStep), 4); // the name goes over the first 4 spaces
+			SetText(WIDGET_STEP, g_TextBuf, len, false, step + (g_bShowInches ? 0x10000L : 0) + (m_bWheelSpeedMode ? 0x20000L : 0)); // the key changes with the text
+		}
+
+		if (pState->m_bShowActions)
+		{
+			SetText(WIDGET_ACTION, ROMSTR("To 0"), 4, true);
+			if (g_bWorkSpace)
 			{
-				DrawButton(BUTTON_STEP, ROMSTR("Align"), 5, true);
+				SetText(WIDGET_SET0, ROMSTR("Set 0"), 5, true);
 			}
 			else
 			{
-				int8_t len = g_bShowInches ? Sprintf(g_TextBuf, "Step %1d.%03d", step/1000, step%1000) : Sprintf(g_TextBuf, "Step %2d.%02d", step/100, step%100);
-				DrawButton(BUTTON_STEP, g_TextBuf, len, false);
-			}
-
-			if (pState->m_bShowActions)
-			{
-				DrawButton(BUTTON_GOTO0, ROMSTR("To 0"), 4, true);
-				if (g_bWorkSpace)
-				{
-					DrawButton(BUTTON_SET0, ROMSTR("Set 0"), 5, true);
-				}
-				else
-				{
-					DrawUnusedButtons(0x40);
-				}
+				SetUnused(WIDGET_SET0);
 			}
-			else if (pState->m_bShowStop)
+		}
+		else
+		{
+			if (pState->m_bShowStop)
 			{
-				DrawButton(BUTTON_STOP, g_StrSTOP, 4, false);
-				DrawUnusedButtons(0x40);
+				SetText(WIDGET_ACTION, g_StrSTOP, 4);
 			}
 			else
 			{
-				DrawUnusedButtons(0x60);
+				SetUnused(WIDGET_ACTION);
 			}
-		}
-		else
-		{
-			// XY selected
-			DrawUnusedButtons(0x68);
-		}
-		DrawButton(BUTTON_BACK, g_StrBack, 4, false);
-	}
-
-	if (bDrawX)
-	{
-		PrintX(g_TextBuf);
-		if (pState->m_Axis & 1)
-		{
-			SetDrawColor(1);
-			DrawBox(0, g_Rows[1] - 1, 8, 10);
-			SetDrawColor(0);
-			DrawText(0, 1, g_StrBoldX);
-			SetDrawColor(1);
-			DrawTextBold(2, 1, g_TextBuf);
-		}
-		else
-		{
-			SetDrawColor(1);
-			DrawText(0, 1, g_StrX);
-			DrawText(2, 1, g_TextBuf);
+			SetUnused(WIDGET_SET0);
 		}
 	}
-
-	if (bDrawY)
+	else
 	{
-		PrintY(g_TextBuf);
-		if (pState->m_Axis & 2)
-		{
-			SetDrawColor(1);
-			DrawBox(0, g_Rows[2] - 1, 8, 10);
-			SetDrawColor(0);
-			DrawText(0, 2, g_StrBoldY);
-			SetDrawColor(1);
-			DrawTextBold(2, 2, g_TextBuf);
-		}
-		else
-		{
-			SetDrawColor(1);
-			DrawText(0, 2, g_StrY);
-			DrawText(2, 2, g_TextBuf);
-		}
+		// XY selected
+		SetUnused(WIDGET_STEP);
+		SetUnused(WIDGET_ACTION);
+		SetUnused(WIDGET_SET0);
 	}
+	SetText(WIDGET_BACK, g_StrBack, 4);
 
-	if (bDrawZ)
-	{
-		PrintZ(g_TextBuf);
-		if (pState->m_Axis & 4)
-		{
-			SetDrawColor(1);
-			DrawBox(0, g_Rows[3] - 1, 8, 10);
-			SetDrawColor(0);
-			DrawText(0, 3, g_StrBoldZ);
-			SetDrawColor(1);
-			DrawTextBold(2, 3, g_TextBuf);
-		}
-		else
-		{
-			SetDrawColor(1);
-			DrawText(0, 3, g_StrZ);
-			DrawText(2, 3, g_TextBuf);
-		}
-	}
+	DrawWidgets(s_Layout, WIDGET_COUNT);
 }
 
 void JogScreen::Update( unsigned long time )
@@ -254,7 +194,7 @@ void JogScreen::Update( unsigned long time )
 		if (pState->m_bShowAlign && TestBit(g_ButtonHold, BUTTON_STEP))
 		{
 			// Step button held down for full time, align to the step rate
-			Serial.print(g_StrJOG2);
+			g_Port.print(g_StrJOG2);
 			uint16_t step = m_StepRates[m_StepIndex];
 			if (g_bShowInches)
 			{
@@ -264,11 +204,20 @@ void JogScreen::Update( unsigned long time )
 			{
 				Sprintf(g_TextBuf, "AM%c%c%d.%02d", g_bWorkSpace ? 'L' : 'G', g_AxisName[pState->m_Axis], step/100, step%100);
 			}
-			Serial.println(g_TextBuf);
+			g_Port.println(g_TextBuf);
 		}
 		else if (!pState->m_bShowAlign && TestBit(g_ButtonUnclick, BUTTON_STEP))
 		{
+			// cycle through the steps, then through the same steps in the MPG mode
 			m_StepIndex = (m_StepIndex + 1) % m_StepRateCount;
+			if (m_StepIndex == 0)
+			{
+				if (pState->m_WheelSpeed != 0)
+				{
+					SendWheelSpeed(0);
+				}
+				m_bWheelSpeedMode = !m_bWheelSpeedMode;
+			}
 		}
 
 		if (pState->m_bShowActions && g_MachineStatus == STATUS_IDLE)
@@ -276,41 +225,36 @@ void JogScreen::Update( unsigned long time )
 			if (TestBit(g_ButtonHold, BUTTON_SET0) && g_bWorkSpace)
 			{
 				Sprintf(g_TextBuf, "SET0:%c", g_AxisName[pState->m_Axis]);
-				Serial.println(g_TextBuf);
+				g_Port.println(g_TextBuf);
 			}
 			else if (TestBit(g_ButtonHold, BUTTON_GOTO0))
 			{
-				Serial.print(g_StrJOG2);
+				g_Port.print(g_StrJOG2);
 				Sprintf(g_TextBuf, "0%c%c", g_bWorkSpace ? 'L' : 'G', g_AxisName[pState->m_Axis]);
-				Serial.println(g_TextBuf);
+				g_Port.println(g_TextBuf);
 			}
 		}
 		else if (pState->m_bShowStop && button == BUTTON_STOP)
 		{
-			Serial.println(g_StrSTOP);
+			g_Port.SendRealtime(REALTIME_STOP);
 		}
 
 		// process wheel, but not too frequently
-		if (time - pState->m_LastWheelTime >= WHEEL_UPDATE_TIME)
+		if (m_bWheelSpeedMode)
+		{
+			UpdateWheelSpeed(time);
+		}
+		else if (time - pState->m_LastWheelTime >= WHEEL_UPDATE_TIME)
 		{
 			int16_t wheel = EncoderDrainValue();
 			if (wheel != 0)
 			{
+				const uint16_t dt = time - pState->m_LastWheelTime > 60000 ? 60000 : time - pState->m_LastWheelTime;
 				pState->m_LastInputTime = time;
 				pState->m_LastWheelTime = time;
 				if (g_MachineStatus == STATUS_IDLE || g_MachineStatus == STATUS_JOG || g_MachineStatus == STATUS_RUNNING)
 				{
-					uint16_t step = m_StepRates[m_StepIndex];
-					if (g_bShowInches)
-					{
-						Sprintf(g_TextBuf, "WI%c%d*%d.%03d", g_AxisName[pState->m_Axis], wheel, step/1000, step%1000);
-					}
-					else
-					{
-						Sprintf(g_TextBuf, "WM%c%d*%d.%02d", g_AxisName[pState->m_Axis], wheel, step/100, step%100);
-					}
-					Serial.print(g_StrJOG2);
-					Serial.println(g_TextBuf);
+					g_Port.SendJogWheel(AccelerateWheel(wheel, dt), g_AxisName[pState->m_Axis], m_StepRates[m_StepIndex], g_bShowInches);
 				}
 			}
 		}
@@ -333,9 +277,14 @@ void JogScreen::Update( unsigned long time )
 				pState->m_OldJoyX = x;
 				pState->m_OldJoyY = y;
 				pState->m_LastJoystickTime = time;
-				Serial.print(g_StrJOG2);
-				Sprintf(g_TextBuf, "JXY%d,%d", x, y);
-				Serial.println(g_TextBuf);
+				if (x == 0 && y == 0)
+				{
+					g_Port.SendRealtime(REALTIME_JOG_CANCEL); // the joystick is released
+				}
+				else
+				{
+					g_Port.SendJogXY(x, y);
+				}
 			}
 		}
 		else if (x != 0 || y != 0)
@@ -362,6 +311,7 @@ void JogScreen::Activate( unsigned long time )
 	pState->m_bShowStop = false;
 	pState->m_bShowActions = true;
 	pState->m_bShowAlign = false;
+	pState->m_WheelSpeed = 0;
 	GetJoystick(&pState->m_OldJoyX, &pState->m_OldJoyY);
 	EncoderDrainValue();
 }
@@ -372,13 +322,15 @@ void JogScreen::Deactivate( void )
 }
 
 // Parses the jog step rate string from the PC - |<rate1>|<rate2> ... - up to 5
-void JogScreen::ParseJogSteps( const char *str )
+void JogScreen::ParseJogSteps( char **steps, uint8_t count )
 {
 	m_StepRateCount = 0;
-	while (str && m_StepRateCount < 5)
+	for (uint8_t i = 0; i < count && m_StepRateCount < 5; i++)
 	{
-		m_StepRates[m_StepRateCount++] = atol(str + 1);
-		str = strchr(str + 1, '|');
+		if (steps[i][0])
+		{
+			m_StepRates[m_StepRateCount++] = atol(steps[i]);
+		}
 	}
 	if (m_StepRateCount == 0)
 	{
@@ -396,8 +348,115 @@ void JogScreen::ParseJogSteps( const char *str )
 #endif
 }
 
+// Parses the wheel acceleration curve from the PC - <speed1>,<factor1>,<speed2>,<factor2> ... - up to 4 points
+// The speeds must be increasing. No points disables the acceleration
+void JogScreen::ParseWheelAccel( char **fields, uint8_t count )
+{
+	m_AccelPointCount = 0;
+	for (uint8_t i = 0; i + 1 < count && m_AccelPointCount < MAX_ACCEL_POINTS; i += 2)
+	{
+		const int speed = atoi(fields[i]);
+		const int factor = atoi(fields[i + 1]);
+		if (speed <= 0 || speed > 255 || factor <= 0 || factor > 255) break;
+		if (m_AccelPointCount > 0 && speed <= m_AccelCurve[m_AccelPointCount - 1].speed) break;
+		m_AccelCurve[m_AccelPointCount].speed = speed;
+		m_AccelCurve[m_AccelPointCount].factor = factor;
+		m_AccelPointCount++;
+	}
+}
+
+// Multiplies the wheel clicks based on the wheel speed. dt is the time in ms since the previous clicks were sent, so
+// the first clicks after a pause always move by the exact step
+int16_t JogScreen::AccelerateWheel( int16_t wheel, uint16_t dt ) const
+{
+	if (m_AccelPointCount == 0 || dt == 0)
+	{
+		return wheel;
+	}
+
+	const uint16_t clicks = wheel < 0 ? -wheel : wheel;
+	const uint32_t speed = clicks * 1000ul / dt; // clicks per second
+	uint16_t factor = 1;
+	if (speed >= m_AccelCurve[m_AccelPointCount - 1].speed)
+	{
+		factor = m_AccelCurve[m_AccelPointCount - 1].factor;
+	}
+	else
+	{
+		for (uint8_t i = 0; i < m_AccelPointCount; i++)
+		{
+			const AccelPoint &p1 = m_AccelCurve[i];
+			if (speed < p1.speed)
+			{
+				if (i > 0)
+				{
+					const AccelPoint &p0 = m_AccelCurve[i - 1];
+					// 32-bit product, the differences can reach 254 each. the result stays between the two factors
+					const int32_t f = p0.factor + (int32_t)(p1.factor - p0.factor) * (int32_t)(speed - p0.speed) / (p1.speed - p0.speed);
+					const uint8_t lo = p0.factor < p1.factor ? p0.factor : p1.factor;
+					const uint8_t hi = p0.factor < p1.factor ? p1.factor : p0.factor;
+					factor = f < lo ? lo : f > hi ? hi : (uint16_t)f;
+				}
+				break;
+			}
+		}
+	}
+
+	const int32_t result = (int32_t)wheel * factor;
+	return result > 32767 ? 32767 : result < -32767 ? -32767 : (int16_t)result;
+}
+
+// In the MPG mode the wheel speed is sent every WHEEL_UPDATE_TIME while the wheel turns, and 0 as soon as it stops.
+// The PC turns it into short continuous jogs, so the machine follows the wheel and stops with it
+void JogScreen::UpdateWheelSpeed( unsigned long time )
+{
+	auto *pState = GetActiveState();
+	if (time - pState->m_LastWheelTime < WHEEL_UPDATE_TIME)
+	{
+		return;
+	}
+
+	int16_t wheel = EncoderDrainValue();
+	int16_t speed = 0;
+	if (wheel != 0)
+	{
+		const uint16_t dt = time - pState->m_LastWheelTime > WHEEL_MAX_SAMPLE_TIME ? WHEEL_MAX_SAMPLE_TIME : time - pState->m_LastWheelTime;
+		const int32_t s = (int32_t)wheel * 1000 / dt; // clicks per second
+		speed = s > 32767 ? 32767 : s < -32767 ? -32767 : (int16_t)s;
+		pState->m_LastInputTime = time;
+		pState->m_LastWheelTime = time;
+	}
+	else if (pState->m_WheelSpeed == 0 || time - pState->m_LastWheelTime < WHEEL_STOP_TIME)
+	{
+		return; // not moving, or waiting for the next click
+	}
+
+	if (speed == 0 || g_MachineStatus == STATUS_IDLE || g_MachineStatus == STATUS_JOG)
+	{
+		SendWheelSpeed(speed);
+	}
+}
+
+// Sends JOG:V<I/M><axis><speed>*<step> - the wheel speed in clicks per second and the distance for each click
+void JogScreen::SendWheelSpeed( int16_t speed )
+{
+	auto *pState = GetActiveState();
+	pState->m_WheelSpeed = speed;
+	const uint16_t step = m_StepRates[m_StepIndex];
+	g_Port.print(g_StrJOG2);
+	if (g_bShowInches)
+	{
+		Sprintf(g_TextBuf, "VI%c%d*%d.%03d", g_AxisName[pState->m_Axis], speed, step/1000, step%1000);
+	}
+	else
+	{
+		Sprintf(g_TextBuf, "VM%c%d*%d.%02d", g_AxisName[pState->m_Axis], speed, step/100, step%100);
+	}
+	g_Port.println(g_TextBuf);
+}
+
 void JogScreen::GetJoystick( int8_t *px, int8_t *py )
 {
-	*px = QuantizeJoystick(g_JoyX, g_RomSettings.calibration);
-	*py = QuantizeJoystick(g_JoyY, g_RomSettings.calibration + 4);
+	*px = QuantizeJoystick(g_JoyX, g_JoyAxes[0]);
+	*py = QuantizeJoystick(g_JoyY, g_JoyAxes[1]);
 }
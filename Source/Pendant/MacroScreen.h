@@ -1,7 +1,7 @@
 void MacroScreen::Draw( void )
 {
 #if PARTIAL_SCREEN_UPDATE
-	if (!s_DrawState.bDrawAll) return;
+	if (!s_DrawState.bDrawAll && !HasDirtyRegions()) return;
 #endif
 	DrawMachineStatus(ROMSTR("MACROS"), 6);
 	DrawUnusedButtons(m_UnusedMacros);
@@ -39,8 +39,8 @@ void MacroScreen::Update( unsigned long time )
 			continue;
 		}
 
-		Serial.print(ROMSTR("RUNMACRO:"));
-		Serial.println(i + 1);
+		g_Port.print(ROMSTR("RUNMACRO:"));
+		g_Port.println(i + 1);
 		return;
 	}
 
@@ -52,25 +52,22 @@ void MacroScreen::Update( unsigned long time )
 
 // Parses the MACROS: string from the PC
 // <hold flags>|<macro1>|<macro2>|<macro3>|<macro4>|<macro5>|<macro6>|<macro7>|
-void MacroScreen::ParseMacros( const char *macros )
+void MacroScreen::ParseMacros( char **fields )
 {
-	m_MacroHoldFlags = atol(macros);
+	m_MacroHoldFlags = atol(fields[0]);
 	m_UnusedMacros = 0;
 
-	macros = strchr(macros, '|') + 1;
 	for (uint8_t idx = 0; idx < 7; idx++)
 	{
-		const char *end = strchr(macros, '|');
-		int16_t len = (int16_t)(end - macros);
+		int16_t len = Strlen(fields[idx + 1]);
 		if (len > 8) len = 8;
 		char *name = m_MacroNames[idx];
-		memcpy(name, macros, len);
+		memcpy(name, fields[idx + 1], len);
 		name[len] = 0;
 		if (len == 0)
 		{
 			m_UnusedMacros |= 1 << idx;
 		}
-		macros = end + 1;
 	}
 
 #if PARTIAL_SCREEN_UPDATE
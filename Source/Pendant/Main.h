@@ -15,9 +15,15 @@ char g_TextBuf[20];
 #include "Graphics.h"
 #include "Input.h"
 #include "MachineStatus.h"
+#include "Protocol.h"
 
 const unsigned long PING_TIME = 10000; // 10 seconds of no PONG will disconnect (could be shorter, but I noticed that when VSCode starts up, the COM traffic stalls for a few seconds)
+const unsigned long BAUD_CONFIRM_TIME = 1000; // after switching the baud rate, the PC must confirm it with PEN within 1 second
+const uint8_t BAUD_MAX_ERRORS = 3; // go back to PENDANT_BAUD_RATE after 3 corrupted frames or lines
+const unsigned long SERIAL_TIME_BUDGET = 2000; // process the incoming commands for up to 2ms per frame. the rest wait for the next frame
 const unsigned long SHOW_STOP_TIME = 500; // after 500ms after the last idle, allow showing s STOP button
+const unsigned long MIN_FRAME_TIME = 1000 / MAX_FRAME_RATE; // don't draw frames more often than this
+const unsigned long FRAME_REFRESH_TIME = 100; // redraw at least this often, for the parts of the screens that change with time
 
 ///////////////////////////////////////////////////////////////////////////////
 // State
@@ -30,6 +36,12 @@ bool g_bWDTCrash;
 const bool g_bWDTCrash = false;
 #endif
 
+#if PENDANT_MAX_BAUD_RATE > PENDANT_BAUD_RATE
+unsigned long g_BaudRate = PENDANT_BAUD_RATE;
+unsigned long g_BaudSwitchTime; // when the baud rate was switched. 0 after the PC confirms it
+uint8_t g_LinkErrorCount; // corrupted frames and lines since the baud rate switch
+#endif
+
 unsigned long g_CurrentTime;
 unsigned long g_LastPingTime;
 unsigned long g_LastPongTime;
@@ -37,9 +49,9 @@ unsigned long g_LastIdleTime;
 unsigned long g_LastBusyTime;
 bool g_bCanShowStop;
 
-// coordinate systems
-float g_WorkX, g_WorkY, g_WorkZ;
-float g_OffsetX, g_OffsetY, g_OffsetZ; // machine = work + offset
+// coordinate systems, in micrometers
+int32_t g_WorkX, g_WorkY, g_WorkZ;
+int32_t g_OffsetX, g_OffsetY, g_OffsetZ; // machine = work + offset
 bool g_bWorkSpace = true;
 bool g_bShowInches = true;
 bool g_bJobRunning = false;
@@ -67,6 +79,7 @@ uint16_t g_RealSpeed;
 
 #include "_BaseScreen.h"
 BaseScreen *BaseScreen::s_pCurrentScreen;
+#include "_WidgetScreen.h"
 #include "_ScreenClasses.h"
 
 AlarmScreen g_AlarmScreen;
@@ -129,9 +142,55 @@ char g_SerialBuffer[128];
 int g_SerialBufferLen = 0;
 
 #define CHAR_ACK '\x1F'
-DEFINE_STRING(g_StrAck, "\x1F");
 
-const char *ProcessSerial( void )
+#if PENDANT_MAX_BAUD_RATE > PENDANT_BAUD_RATE
+void SetBaudRate( unsigned long rate )
+{
+	g_Port.Flush(); // finish sending at the old rate
+	Serial.begin(rate);
+	g_BaudRate = rate;
+	g_BaudSwitchTime = 0;
+	g_LinkErrorCount = 0;
+}
+#endif
+
+// Counts a corrupted frame or line. After BAUD_MAX_ERRORS of them since a baud rate switch the link is not reliable at
+// the high speed, so it goes back to PENDANT_BAUD_RATE. The PC does the same
+void CountLinkError( void )
+{
+#if PENDANT_MAX_BAUD_RATE > PENDANT_BAUD_RATE
+	if (g_BaudRate != PENDANT_BAUD_RATE && ++g_LinkErrorCount >= BAUD_MAX_ERRORS)
+	{
+		SetBaudRate(PENDANT_BAUD_RATE);
+	}
+#endif
+}
+
+bool g_bLineOverflow = false; // the current ASCII line didn't fit in g_SerialBuffer
+
+#if USE_BINARY_PROTOCOL
+uint8_t g_FrameBuffer[MAX_FRAME_SIZE];
+uint8_t g_FrameBufferLen = 0;
+bool g_bFrameOverflow = false;
+bool g_bTextDropped = false; // a part of the current text command was lost
+
+char *ProcessFrame( void );
+
+// Checks if the frame buffer ends with PEN or PEN\r when \n arrives, meaning the PC restarted the ASCII handshake
+bool IsReconnect( void )
+{
+	uint8_t len = g_FrameBufferLen;
+	if (len > 0 && g_FrameBuffer[len - 1] == '\r')
+	{
+		len--;
+	}
+	return len >= 3 && memcmp(g_FrameBuffer + len - 3, "PEN", 3) == 0;
+}
+#endif
+
+// Reads the input until a complete command is received. Returns NULL if there are no more complete commands. A partial
+// command stays in the buffer until the rest arrives
+char *ProcessSerial( void )
 {
 	int16_t av = Serial.available();
 	if (av > 0)
@@ -140,20 +199,64 @@ const char *ProcessSerial( void )
 		{
 			char ch = Serial.read();
 
+#if USE_BINARY_PROTOCOL
+			if (g_bBinaryMode)
+			{
+				g_RxCount++;
+				if (ch == 0)
+				{
+					char *command = ProcessFrame();
+					if (command)
+					{
+						return command;
+					}
+				}
+				else if (ch == '\n' && IsReconnect())
+				{
+					// the PC reconnected and started over with the ASCII handshake. anything before it is a leftover of
+					// the old connection
+					g_FrameBufferLen = 0;
+					g_bFrameOverflow = false;
+					strcpy(g_SerialBuffer, "PEN");
+					return g_SerialBuffer;
+				}
+				else
+				{
+					if (g_FrameBufferLen == MAX_FRAME_SIZE)
+					{
+						// the frame is lost, but keep the last bytes so a PEN handshake can still be recognized
+						g_bFrameOverflow = true;
+						memmove(g_FrameBuffer, g_FrameBuffer + MAX_FRAME_SIZE - 4, 4);
+						g_FrameBufferLen = 4;
+					}
+					g_FrameBuffer[g_FrameBufferLen++] = ch;
+				}
+				continue;
+			}
+#endif
+
 			if (ch == CHAR_ACK)
 			{
-				// incomplete command. notify PC to send more
-				Serial.println(g_StrAck);
-				return NULL;
+				// incomplete command. notify PC to send more, and keep reading in case more was already received
+				g_Port.SendAck();
+				continue;
 			}
 
 			if (ch == '\n')
 			{
 				g_SerialBuffer[g_SerialBufferLen] = 0;
 				g_SerialBufferLen = 0;
-				if (strcmp(g_SerialBuffer,"PEN") != 0 && strcmp(g_SerialBuffer,"BYE") != 0) // the initial handshake and BYE don't need ACK
+				// the initial handshake and BYE don't need ACK. PROTO: and BAUD: send their own response
+				if (strcmp(g_SerialBuffer,"PEN") != 0 && strcmp(g_SerialBuffer,"BYE") != 0 && strncmp(g_SerialBuffer,"PROTO:",6) != 0 && strncmp(g_SerialBuffer,"BAUD:",5) != 0)
+				{
+					g_Port.SendAck();
+				}
+				if (g_bLineOverflow)
 				{
-					Serial.println(g_StrAck);
+					// the line is truncated. ignore it
+					g_bLineOverflow = false;
+					CountLinkError();
+					continue;
 				}
 				return g_SerialBuffer;
 			}
@@ -161,176 +264,576 @@ const char *ProcessSerial( void )
 			{
 				g_SerialBuffer[g_SerialBufferLen++] = ch;
 			}
+			else
+			{
+				g_bLineOverflow = true;
+			}
 		}
 	}
 
 	return NULL;
 }
 
-// Parses the STATUS: string from the PC
-// string format: <status>|workX,workY,workZ|feed%,rpm%,realFeed,realRpm
-void ParseStatus( const char *status )
+// Parses a coordinate in mm with up to 3 decimals and returns it in micrometers. Extra decimals are rounded
+int32_t ParseCoord( const char *str )
 {
-	g_MachineStatus = (MachineStatus)atol(status); status = strchr(status, '|') + 1;
-	g_WorkX = atof(status); status = strchr(status, ',') + 1;
-	g_WorkY = atof(status); status = strchr(status, ',') + 1;
-	g_WorkZ = atof(status); status = strchr(status, '|') + 1;
-	g_FeedOverride = atoi(status); status = strchr(status, ',') + 1;
-	g_SpeedOverride = atoi(status); status = strchr(status, ',') + 1;
-	g_RealFeed = atoi(status); status = strchr(status, ',') + 1;
-	g_RealSpeed = atoi(status);
-	status = strchr(status, '|');
-	g_JobProgress = status ? atoi(status + 1) : -1;
+	bool bNegative = *str == '-';
+	if (bNegative) str++;
+	int32_t value = 0;
+	while (*str >= '0' && *str <= '9')
+	{
+		value = value * 10 + (*str++ - '0');
+	}
+	uint8_t decimals = 0;
+	if (*str == '.')
+	{
+		str++;
+		for (; decimals < 3 && *str >= '0' && *str <= '9'; decimals++)
+		{
+			value = value * 10 + (*str++ - '0');
+		}
+		if (decimals == 3 && *str >= '5' && *str <= '9')
+		{
+			value++;
+		}
+	}
+	for (; decimals < 3; decimals++)
+	{
+		value *= 10;
+	}
+	return bNegative ? -value : value;
+}
+
+// Parses the STATUS: fields from the PC
+// string format: <status>|workX,workY,workZ|feed%,rpm%,realFeed,realRpm[|progress]
+void ParseStatus( char **fields, uint8_t count )
+{
+	g_MachineStatus = (MachineStatus)atoi(fields[0]);
+	g_WorkX = ParseCoord(fields[1]);
+	g_WorkY = ParseCoord(fields[2]);
+	g_WorkZ = ParseCoord(fields[3]);
+	g_FeedOverride = atoi(fields[4]);
+	g_SpeedOverride = atoi(fields[5]);
+	g_RealFeed = atoi(fields[6]);
+	g_RealSpeed = atoi(fields[7]);
+	g_JobProgress = count > 8 ? atoi(fields[8]) : -1;
 }
 
-// Parses the STATUS2: string from the PC
-// string format: offsetX,offsetY,offsetZ
-void ParseStatus2( const char *status )
+// Parses the STATUS2: fields from the PC
+// string format: [J][H][P]<probe state>offsetX,offsetY,offsetZ
+void ParseStatus2( char **fields )
 {
+	const char *status = fields[0];
 	g_bJobRunning = status[0] == 'J';
 	if (g_bJobRunning) status++;
 	g_bRecentlyHomed = status[0] == 'H';
 	if (g_bRecentlyHomed) status++;
 	g_bProbeContact = status[0] == 'P';
 	if (g_bProbeContact) status++;
+	if (status[0] == 0) return;
 	g_ProbeState = status[0];
 	g_ProbeState = g_ProbeState <= '9' ? g_ProbeState - '0' : g_ProbeState - 55;
 	status++;
-	g_OffsetX = atof(status); status = strchr(status, ',') + 1;
-	g_OffsetY = atof(status); status = strchr(status, ',') + 1;
-	g_OffsetZ = atof(status);
+	g_OffsetX = ParseCoord(status);
+	g_OffsetY = ParseCoord(fields[1]);
+	g_OffsetZ = ParseCoord(fields[2]);
 }
 
-// Parses the UNITS: string from the PC
-// string format: <I/M>|<jog1>|<jog2>| ... up to 5 jog values
-void ParseUnits( const char *units )
+#if USE_BINARY_PROTOCOL
+const uint8_t STATUS_FRAME_SIZE = 23;
+const uint8_t STATUS2_FRAME_SIZE = 14;
+
+// The fields of the main status, in the order used by the delta frames. Must match GetStatusValues in Pendant.js
+enum
+{
+	STATUS_FIELD_STATUS,
+	STATUS_FIELD_WORK_X,
+	STATUS_FIELD_WORK_Y,
+	STATUS_FIELD_WORK_Z,
+	STATUS_FIELD_FEED_OVERRIDE,
+	STATUS_FIELD_SPEED_OVERRIDE,
+	STATUS_FIELD_REAL_FEED,
+	STATUS_FIELD_REAL_SPEED,
+	STATUS_FIELD_PROGRESS,
+	STATUS_FIELD_COUNT
+};
+
+int32_t g_StatusFields[STATUS_FIELD_COUNT]; // the last received status. the deltas are applied to it
+uint8_t g_StatusSeq; // sequence number of the last received status frame
+bool g_bStatusSynced; // a keyframe was received and no updates were missed since
+bool g_bResyncRequested;
+
+void ApplyStatusFields( void )
 {
-	g_bShowInches = *units == 'I';
-	units = strchr(units, '|');
-	g_JogScreen.ParseJogSteps(units);
+	g_MachineStatus = (MachineStatus)g_StatusFields[STATUS_FIELD_STATUS];
+	g_WorkX = g_StatusFields[STATUS_FIELD_WORK_X];
+	g_WorkY = g_StatusFields[STATUS_FIELD_WORK_Y];
+	g_WorkZ = g_StatusFields[STATUS_FIELD_WORK_Z];
+	g_FeedOverride = g_StatusFields[STATUS_FIELD_FEED_OVERRIDE];
+	g_SpeedOverride = g_StatusFields[STATUS_FIELD_SPEED_OVERRIDE];
+	g_RealFeed = g_StatusFields[STATUS_FIELD_REAL_FEED];
+	g_RealSpeed = g_StatusFields[STATUS_FIELD_REAL_SPEED];
+	g_JobProgress = g_StatusFields[STATUS_FIELD_PROGRESS];
+	StateChanged();
 }
 
-// Handles the PEN handshake prompt from the PC. responds with DENT:<version> and the current ROM settings
-void HandleHandshake( void )
+// Parses the STATUS frame (keyframe) from the PC
+// payload: <status:u8> <workX:i32> <workY:i32> <workZ:i32> <feed%:u16> <rpm%:u16> <realFeed:u16> <realRpm:u16> <progress:i8> <seq:u8>
+// the coordinates are in micrometers
+void ParseStatusFrame( const uint8_t *data )
 {
-	Serial.print(ROMSTR("DANT:"));
-	Serial.println(ROMSTR(PENDANT_VERSION));
-	g_LastPingTime = g_LastPongTime = g_CurrentTime;
+	g_StatusFields[STATUS_FIELD_STATUS] = data[0];
+	g_StatusFields[STATUS_FIELD_WORK_X] = ReadInt32(data + 1);
+	g_StatusFields[STATUS_FIELD_WORK_Y] = ReadInt32(data + 5);
+	g_StatusFields[STATUS_FIELD_WORK_Z] = ReadInt32(data + 9);
+	g_StatusFields[STATUS_FIELD_FEED_OVERRIDE] = ReadUint16(data + 13);
+	g_StatusFields[STATUS_FIELD_SPEED_OVERRIDE] = ReadUint16(data + 15);
+	g_StatusFields[STATUS_FIELD_REAL_FEED] = ReadUint16(data + 17);
+	g_StatusFields[STATUS_FIELD_REAL_SPEED] = ReadUint16(data + 19);
+	g_StatusFields[STATUS_FIELD_PROGRESS] = (int8_t)data[21];
+	g_StatusSeq = data[22];
+	g_bStatusSynced = true;
+	g_bResyncRequested = false;
+	ApplyStatusFields();
 }
 
-// Sends the current ROM settings
-void HandleSettings( void )
+// Parses the STATUS_DELTA frame from the PC
+// payload: <seq:u8> <mask:u16> <delta>...
+// there is one zigzag varint delta for every bit set in the mask, in the STATUS_FIELD_ order. if a frame is missed
+// the pendant requests a new keyframe and ignores the deltas until it arrives
+void ParseStatusDeltaFrame( const uint8_t *data, uint8_t len )
 {
-	Serial.print(ROMSTR("NAME:"));
-	Serial.println(g_RomSettings.pendantName);
-	Serial.print(ROMSTR("CALIBRATION:"));
-	for (uint8_t i = 0; i < 7; i++)
+	const uint8_t *end = data + len;
+	int32_t fields[STATUS_FIELD_COUNT];
+	bool bValid = len >= 3 && g_bStatusSynced && data[0] == (uint8_t)(g_StatusSeq + 1);
+	if (bValid)
 	{
-		Serial.print(g_RomSettings.calibration[i]);
-		Serial.print(g_StrComma);
+		uint16_t mask = ReadUint16(data + 1);
+		data += 3;
+		for (uint8_t i = 0; i < STATUS_FIELD_COUNT && bValid; i++)
+		{
+			int32_t delta = 0;
+			if ((mask & (1 << i)) && !ReadZigzag(data, end, delta))
+			{
+				bValid = false;
+			}
+			fields[i] = g_StatusFields[i] + delta;
+		}
 	}
-	Serial.println(g_RomSettings.calibration[7]);
-}
 
-// Processes a command from the PC
-void ProcessCommand( const char *command, unsigned long time )
-{
-	// handshake
-	if (strcmp(command, "PEN") == 0)
+	if (!bValid)
 	{
-		HandleHandshake();
+		g_bStatusSynced = false;
+		if (!g_bResyncRequested)
+		{
+			g_bResyncRequested = true;
+			g_Port.SendFrame(FRAME_RESYNC, NULL, 0);
+		}
 		return;
 	}
-	if (strcmp(command, "SETTINGS") == 0)
+
+	g_StatusSeq++;
+	memcpy(g_StatusFields, fields, sizeof(fields));
+	ApplyStatusFields();
+}
+
+// Parses the STATUS2 frame from the PC
+// payload: <flags:u8> <probeState:u8> <offsetX:i32> <offsetY:i32> <offsetZ:i32>
+// flags: 1 - job running, 2 - recently homed, 4 - probe contact
+void ParseStatus2Frame( const uint8_t *data )
+{
+	g_bJobRunning = (data[0] & 1) != 0;
+	g_bRecentlyHomed = (data[0] & 2) != 0;
+	g_bProbeContact = (data[0] & 4) != 0;
+	g_ProbeState = data[1];
+	g_OffsetX = ReadInt32(data + 2);
+	g_OffsetY = ReadInt32(data + 6);
+	g_OffsetZ = ReadInt32(data + 10);
+	StateChanged();
+}
+
+// Processes the frame collected in g_FrameBuffer. Returns the text command if the frame completes one
+char *ProcessFrame( void )
+{
+	uint8_t len = g_bFrameOverflow ? 0 : CobsDecode(g_FrameBuffer, g_FrameBufferLen);
+	g_FrameBufferLen = 0;
+	g_bFrameOverflow = false;
+
+	if (len < FRAME_OVERHEAD || Crc16(g_FrameBuffer, len - 2) != ReadUint16(g_FrameBuffer + len - 2))
 	{
-		HandleSettings();
-		return;
+		// corrupted frame. if it was a part of a text command, the whole command is lost
+		if (g_SerialBufferLen > 0)
+		{
+			g_bTextDropped = true;
+		}
+		CountLinkError();
+		return NULL;
 	}
-	if (strcmp(command, "BYE") == 0)
+
+	const uint8_t *payload = g_FrameBuffer + 1;
+	len -= FRAME_OVERHEAD;
+	switch (g_FrameBuffer[0])
 	{
-		g_bConnected = false;
-		g_bTimedOut = false;
-		g_MachineStatus = STATUS_DISCONNECTED;
-		return;
+		case FRAME_TEXT:
+		case FRAME_TEXT_PART:
+			if (g_SerialBufferLen + len < sizeof(g_SerialBuffer))
+			{
+				memcpy(g_SerialBuffer + g_SerialBufferLen, payload, len);
+				g_SerialBufferLen += len;
+			}
+			else if (!g_bTextDropped)
+			{
+				g_bTextDropped = true;
+				CountLinkError(); // too long for the buffer
+			}
+			if (g_FrameBuffer[0] == FRAME_TEXT)
+			{
+				g_SerialBuffer[g_SerialBufferLen] = 0;
+				g_SerialBufferLen = 0;
+				if (g_bTextDropped)
+				{
+					g_bTextDropped = false;
+					return NULL;
+				}
+				return g_SerialBuffer;
+			}
+			break;
+
+		case FRAME_STATUS:
+			if (len == STATUS_FRAME_SIZE)
+			{
+				g_bConnected = true;
+				g_bTimedOut = false;
+				ParseStatusFrame(payload);
+			}
+			break;
+
+		case FRAME_STATUS_DELTA:
+			g_bConnected = true;
+			g_bTimedOut = false;
+			ParseStatusDeltaFrame(payload, len);
+			break;
+
+		case FRAME_STATUS2:
+			if (len == STATUS2_FRAME_SIZE)
+			{
+				ParseStatus2Frame(payload);
+			}
+			break;
+
+		case FRAME_PONG:
+			g_LastPongTime = g_CurrentTime;
+			break;
 	}
+	return NULL;
+}
+#endif
 
-	// heartbeat
-	if (strcmp(command, "PONG") == 0)
+// Parses the UNITS: fields from the PC
+// string format: <I/M>|<jog1>|<jog2>| ... up to 5 jog values
+void ParseUnits( char **fields, uint8_t count )
+{
+	g_bShowInches = fields[0][0] == 'I';
+	g_JogScreen.ParseJogSteps(fields + 1, count - 1);
+}
+
+// Handles the PEN handshake prompt from the PC. responds with DENT:<version> and the current ROM settings
+void HandleHandshake( void )
+{
+#if USE_BINARY_PROTOCOL
+	g_bBinaryMode = false; // every connection starts with the ASCII protocol
+#endif
+#if PENDANT_MAX_BAUD_RATE > PENDANT_BAUD_RATE
+	g_BaudSwitchTime = 0; // the PC confirmed the new baud rate
+#endif
+	g_Port.Reset(); // anything still queued was meant for the previous connection
+	g_bRealtimeCodes = false; // until the PC sends PROTO:
+	g_Port.print(ROMSTR("DANT:"));
+	g_Port.println(ROMSTR(PENDANT_VERSION));
+	g_LastPingTime = g_LastPongTime = g_CurrentTime;
+}
+
+// Sends the current ROM settings
+void HandleSettings( char **fields, uint8_t count, unsigned long time )
+{
+	g_Port.print(ROMSTR("NAME:"));
+	g_Port.println(g_RomSettings.pendantName);
+	g_Port.print(ROMSTR("CALIBRATION:"));
+	for (uint8_t i = 0; i < 7; i++)
 	{
-		g_LastPongTime = time;
-		return;
+		g_Port.print(g_RomSettings.calibration[i]);
+		g_Port.print(g_StrComma);
+	}
+	g_Port.println(g_RomSettings.calibration[7]);
+	g_Port.print(ROMSTR("JOYCURVE:"));
+	for (uint8_t i = 0; i < JOYSTICK_CURVE_POINTS - 1; i++)
+	{
+		g_Port.print(g_RomSettings.joyCurve[i]);
+		g_Port.print(g_StrComma);
 	}
+	g_Port.println(g_RomSettings.joyCurve[JOYSTICK_CURVE_POINTS - 1]);
+}
 
-	// status
-	if (strncmp(command, "STATUS:", 7) == 0)
+// Handles the BAUD: request from the PC. Responds with the rate the pendant switches to - the requested rate, limited
+// by PENDANT_MAX_BAUD_RATE. The PC must confirm the new rate with PEN, otherwise the pendant goes back to PENDANT_BAUD_RATE
+void HandleBaudRate( char **fields, uint8_t count, unsigned long time )
+{
+	unsigned long baud = strtoul(fields[0], NULL, 10);
+	if (baud > PENDANT_MAX_BAUD_RATE) baud = PENDANT_MAX_BAUD_RATE;
+	if (baud < PENDANT_BAUD_RATE) baud = PENDANT_BAUD_RATE;
+	g_Port.print(ROMSTR("BAUD:"));
+	g_Port.println(baud);
+#if PENDANT_MAX_BAUD_RATE > PENDANT_BAUD_RATE
+	if (baud != g_BaudRate)
 	{
-		g_bConnected = true;
-		g_bTimedOut = false;
-		ParseStatus(command + 7);
-		return;
+		SetBaudRate(baud);
+		g_BaudSwitchTime = time;
 	}
+#endif
+}
 
-	// status2
-	if (strncmp(command, "STATUS2:", 8) == 0)
+// Handles the PROTO: request from the PC. responds with the protocol that will be used from now on
+void HandleProtocol( char **fields, uint8_t count, unsigned long time )
+{
+	g_bRealtimeCodes = true; // the PC knows PROTO:, so it knows the realtime codes too
+#if USE_BINARY_PROTOCOL
+	if (fields[0][0] == 'B')
 	{
-		ParseStatus2(command + 8);
+		g_Port.print(ROMSTR("PROTO:B"));
+		g_Port.println(RX_WINDOW);
+		g_bBinaryMode = true;
+		g_RxCount = g_RxCountSent = 0;
+		g_bStatusSynced = false;
+		g_bResyncRequested = false;
+		g_FrameBufferLen = 0;
+		g_bFrameOverflow = false;
+		g_bTextDropped = false;
 		return;
 	}
+#endif
+	g_Port.println(ROMSTR("PROTO:A"));
+}
 
-	//settings
-	if (strncmp(command, "UNITS:", 6) == 0)
+///////////////////////////////////////////////////////////////////////////////
+// Commands from the PC
+
+enum
+{
+	SEP_BAR = 1, // split the fields at '|'
+	SEP_COMMA = 2, // split the fields at ','
+};
+
+const uint8_t MAX_COMMAND_FIELDS = 10;
+
+// Splits the string in place at the separators. Returns the number of fields. If there are too many fields, the last
+// one contains the rest of the string
+uint8_t Tokenize( char *str, uint8_t separators, char **fields, uint8_t maxFields )
+{
+	uint8_t count = 0;
+	fields[count++] = str;
+	for (; *str && count < maxFields; str++)
 	{
-		ParseUnits(command + 6);
-		return;
+		if ((*str == '|' && (separators & SEP_BAR)) || (*str == ',' && (separators & SEP_COMMA)))
+		{
+			*str = 0;
+			fields[count++] = str + 1;
+		}
 	}
-	if (strncmp(command, "MACROS:", 7) == 0)
+	return count;
+}
+
+void HandlePen( char **fields, uint8_t count, unsigned long time )
+{
+	HandleHandshake();
+}
+
+void HandleBye( char **fields, uint8_t count, unsigned long time )
+{
+#if USE_BINARY_PROTOCOL
+	g_bBinaryMode = false;
+#endif
+#if PENDANT_MAX_BAUD_RATE > PENDANT_BAUD_RATE
+	if (g_BaudRate != PENDANT_BAUD_RATE)
 	{
+		SetBaudRate(PENDANT_BAUD_RATE); // the next connection starts at the default rate
+	}
+#endif
+	g_bConnected = false;
+	g_bTimedOut = false;
+	g_MachineStatus = STATUS_DISCONNECTED;
+	StateChanged();
+}
+
+void HandlePong( char **fields, uint8_t count, unsigned long time )
+{
+	g_LastPongTime = time;
+}
+
+void HandleStatus( char **fields, uint8_t count, unsigned long time )
+{
+	g_bConnected = true;
+	g_bTimedOut = false;
+	ParseStatus(fields, count);
+	StateChanged();
+}
+
+void HandleStatus2( char **fields, uint8_t count, unsigned long time )
+{
+	ParseStatus2(fields);
+	StateChanged();
+}
+
+void HandleUnits( char **fields, uint8_t count, unsigned long time )
+{
+	ParseUnits(fields, count);
+	StateChanged();
+}
+
+void HandleWheelAccel( char **fields, uint8_t count, unsigned long time )
+{
+	g_JogScreen.ParseWheelAccel(fields, count);
+}
+
+void HandleMacros( char **fields, uint8_t count, unsigned long time )
+{
 #ifndef DISABLE_MACRO_SCREEN
-		g_MacroScreen.ParseMacros(command + 7);
+	g_MacroScreen.ParseMacros(fields);
+	StateChanged();
 #endif
-		return;
-	}
+}
 
-	if (strncmp(command, "CAL:", 4) == 0)
-	{
+void HandleCal( char **fields, uint8_t count, unsigned long time )
+{
 #ifndef DISABLE_CALIBRATION_SCREEN
-		g_CalibrationScreen.ProcessCommand(command + 4, time);
+	g_CalibrationScreen.ProcessCommand(fields[0], time);
+	StateChanged();
 #endif
-		return;
-	}
+}
+
+void HandleName( char **fields, uint8_t count, unsigned long time )
+{
+	ParseName(fields[0]);
+	StateChanged();
+}
+
+void HandleCalibration( char **fields, uint8_t count, unsigned long time )
+{
+	ParseCalibration(fields);
+	UpdateJoystickTables();
+}
+
+void HandleJoystickCurve( char **fields, uint8_t count, unsigned long time )
+{
+	ParseJoystickCurve(fields);
+	UpdateJoystickTables();
+}
 
-	if (strncmp(command, "NAME:", 5) == 0)
+void HandleDialog( char **fields, uint8_t count, unsigned long time )
+{
+	if (!g_bWDTCrash)
 	{
-		ParseName(command + 5);
-		return;
+		g_DialogScreen.Activate(time);
+		g_DialogScreen.ParseDialog(fields);
+		StateChanged();
 	}
+}
+
+void HandleJobScreen( char **fields, uint8_t count, unsigned long time )
+{
+	g_RunScreen.Activate(time);
+	StateChanged();
+}
+
+void HandleProbeScreen( char **fields, uint8_t count, unsigned long time )
+{
+	g_ZProbeScreen.Activate(time, (ZProbeScreen::ProbeMode)(fields[0][0] - '0'), false);
+	StateChanged();
+}
+
+typedef void (*CommandHandler)( char **fields, uint8_t count, unsigned long time );
+
+struct CommandEntry
+{
+	char name[12];
+	uint8_t separators; // SEP_ flags for splitting the text after ':'
+	uint8_t minFields; // the command is ignored if it has fewer fields
+	CommandHandler handler;
+};
+
+// Must be sorted by name
+const CommandEntry g_Commands[] PROGMEM =
+{
+	{"BAUD", 0, 1, HandleBaudRate},
+	{"BYE", 0, 0, HandleBye},
+	{"CAL", 0, 1, HandleCal},
+	{"CALIBRATION", SEP_COMMA, 8, HandleCalibration},
+	{"DIALOG", SEP_BAR, 6, HandleDialog},
+	{"JOBSCREEN", 0, 0, HandleJobScreen},
+	{"JOYCURVE", SEP_COMMA, JOYSTICK_CURVE_POINTS, HandleJoystickCurve},
+	{"MACROS", SEP_BAR, 8, HandleMacros},
+	{"NAME", 0, 1, HandleName},
+	{"PEN", 0, 0, HandlePen},
+	{"PONG", 0, 0, HandlePong},
+	{"PROBESCREEN", 0, 1, HandleProbeScreen},
+	{"PROTO", 0, 1, HandleProtocol},
+	{"SETTINGS", 0, 0, HandleSettings},
+	{"STATUS", SEP_BAR | SEP_COMMA, 8, HandleStatus},
+	{"STATUS2", SEP_COMMA, 3, HandleStatus2},
+	{"UNITS", SEP_BAR, 1, HandleUnits},
+	{"WHEELACCEL", SEP_COMMA, 0, HandleWheelAccel},
+};
+
+const int8_t COMMAND_COUNT = sizeof(g_Commands) / sizeof(g_Commands[0]);
 
-	if (strncmp(command, "CALIBRATION:", 12) == 0)
+// Processes a command from the PC. The command name is found with a binary search, then the rest of the command is
+// split in place into fields for the handler. An unknown or incomplete ASCII command counts as a link error
+void ProcessCommand( char *command, unsigned long time )
+{
+	char *args = strchr(command, ':');
+	if (args)
 	{
-		ParseCalibration(command + 12);
-		return;
+		*args++ = 0;
 	}
-
-	if (strncmp(command, "DIALOG:", 7) == 0)
+	else
 	{
-		if (!g_bWDTCrash)
-		{
-			g_DialogScreen.Activate(time);
-			g_DialogScreen.ParseDialog(command + 7);
-		}
-		return;
+		args = command + Strlen(command);
 	}
 
-	if (strcmp(command, "JOBSCREEN") == 0)
+	int8_t first = 0;
+	int8_t last = COMMAND_COUNT - 1;
+	while (first <= last)
 	{
-		g_RunScreen.Activate(time);
-		return;
+		int8_t mid = (first + last) / 2;
+		CommandEntry entry;
+		memcpy_P(&entry, &g_Commands[mid], sizeof(entry));
+		int cmp = strcmp(command, entry.name);
+		if (cmp == 0)
+		{
+			char *fields[MAX_COMMAND_FIELDS];
+			uint8_t count = Tokenize(args, entry.separators, fields, MAX_COMMAND_FIELDS);
+			if (count >= entry.minFields)
+			{
+				entry.handler(fields, count, time);
+				return;
+			}
+			break;
+		}
+		if (cmp < 0)
+		{
+			last = mid - 1;
+		}
+		else
+		{
+			first = mid + 1;
+		}
 	}
 
-	if (strncmp(command, "PROBESCREEN:", 12) == 0)
+	// unknown command or missing fields. in ASCII mode that's a sign of a corrupted line
+#if USE_BINARY_PROTOCOL
+	if (!g_bBinaryMode) // the binary frames are already checked with the CRC
+#endif
 	{
-		g_ZProbeScreen.Activate(time, (ZProbeScreen::ProbeMode)(command[12] - '0'), false);
-		return;
+		CountLinkError();
 	}
 }
 
@@ -350,6 +853,7 @@ void setup( void )
 	InitializeInput();
 	InitializeStatusStrings();
 	ReadRomSettings();
+	UpdateJoystickTables();
 	InitializeGraphics();
 	InitializeEncoder();
 	g_CurrentTime = millis();
@@ -370,8 +874,10 @@ void setup( void )
 		{
 			strcpy_P(dialogText, PSTR("10001|CRASH DETECTED|Watchdog detected|a crash.||,DISMISS"));
 		}
+		char *fields[MAX_COMMAND_FIELDS];
+		Tokenize(dialogText, SEP_BAR, fields, MAX_COMMAND_FIELDS);
 		g_DialogScreen.Activate(g_CurrentTime);
-		g_DialogScreen.ParseDialog(dialogText);
+		g_DialogScreen.ParseDialog(fields);
 	}
 #endif
 
@@ -387,6 +893,63 @@ int g_Frame = 0;
 uint16_t g_Dtt = 0;
 uint16_t g_DtMax = 0;
 
+unsigned long g_LastFrameTime; // when the last frame was drawn
+uint8_t g_DrawnGeneration; // g_StateGeneration of the last drawn frame
+
+#if SCREEN_BENCHMARK
+const unsigned long BENCH_REPORT_TIME = 5000;
+unsigned long g_BenchDrawTime; // microseconds spent drawing frames (including the shadow buffer diff) since the last report
+unsigned long g_BenchFlushTime; // microseconds spent sending tiles since the last report
+uint16_t g_BenchFrames; // frames drawn since the last report
+uint16_t g_BenchSkipped; // loop iterations without drawing a frame since the last report
+unsigned long g_BenchReportTime;
+
+// Sends BENCH:<S|M>,<frames>,<draw us>,<flush us>,<tiles>,<I2C bytes>,<draw calls>,<skipped> to the PC. S is for the
+// shadow buffer, M for the manual change tracking
+void SendBenchmark( unsigned long time )
+{
+	if (time - g_BenchReportTime < BENCH_REPORT_TIME)
+	{
+		return;
+	}
+	g_BenchReportTime = time;
+
+	g_Port.print(SHADOW_SCREEN_BUFFER ? ROMSTR("BENCH:S,") : ROMSTR("BENCH:M,"));
+	g_Port.print((unsigned int)g_BenchFrames);
+	g_Port.print(ROMSTR(","));
+	g_Port.print(g_BenchDrawTime);
+	g_Port.print(ROMSTR(","));
+	g_Port.print(g_BenchFlushTime);
+	g_Port.print(ROMSTR(","));
+	g_Port.print((unsigned int)g_BenchTiles);
+	g_Port.print(ROMSTR(","));
+	g_Port.print(g_BenchTiles * 8ul + g_BenchRuns * (unsigned long)TILE_RUN_OVERHEAD);
+	g_Port.print(ROMSTR(","));
+	g_Port.print((unsigned int)g_BenchDrawCalls);
+	g_Port.print(ROMSTR(","));
+	g_Port.println((unsigned int)g_BenchSkipped);
+	g_BenchDrawTime = g_BenchFlushTime = 0;
+	g_BenchFrames = g_BenchTiles = g_BenchRuns = g_BenchDrawCalls = g_BenchSkipped = 0;
+}
+#endif
+
+// Returns true if a new frame should be drawn - the state changed or a refresh is due, and it's not too soon after
+// the last frame
+bool ShouldDrawFrame( unsigned long time )
+{
+	const unsigned long t = time - g_LastFrameTime;
+	if (t < MIN_FRAME_TIME || (g_DrawnGeneration == g_StateGeneration && t < FRAME_REFRESH_TIME))
+	{
+#if SCREEN_BENCHMARK
+		g_BenchSkipped++;
+#endif
+		return false;
+	}
+	g_LastFrameTime = time;
+	g_DrawnGeneration = g_StateGeneration;
+	return true;
+}
+
 void loop( void )
 {
 	unsigned long time = millis();
@@ -407,19 +970,33 @@ void loop( void )
 			{
 				g_bConnected = false;
 				g_bTimedOut = true;
+				StateChanged();
+#if PENDANT_MAX_BAUD_RATE > PENDANT_BAUD_RATE
+				if (g_BaudRate != PENDANT_BAUD_RATE)
+				{
+					SetBaudRate(PENDANT_BAUD_RATE);
+				}
+#endif
 			}
 			else
 			{
-				Serial.println("PING");
+				g_Port.SendPing();
 				g_LastPingTime = time;
 			}
 		}
 	}
 
-	const char *command = ProcessSerial();
-	if (command)
+#if PENDANT_MAX_BAUD_RATE > PENDANT_BAUD_RATE
+	if (g_BaudSwitchTime != 0 && time - g_BaudSwitchTime > BAUD_CONFIRM_TIME)
+	{
+		SetBaudRate(PENDANT_BAUD_RATE); // the PC didn't confirm the new rate
+	}
+#endif
+
+	// process all received commands, as long as there is time
+	unsigned long serialStart = micros();
+	while (char *command = ProcessSerial())
 	{
-		// process command
 #ifdef EMULATOR
 		if (strcmp(command, "PONG") != 0)
 		{
@@ -429,7 +1006,17 @@ void loop( void )
 		}
 #endif
 		ProcessCommand(command, time);
+		if (micros() - serialStart > SERIAL_TIME_BUDGET)
+		{
+			break;
+		}
+	}
+#if USE_BINARY_PROTOCOL
+	if (g_bBinaryMode)
+	{
+		g_Port.SendCredit();
 	}
+#endif
 
 	// select a screen based on the global status
 	bool bScreenSelected = true;
@@ -482,13 +1069,18 @@ void loop( void )
 		g_LastBusyTime = time;
 	}
 
-	g_bCanShowStop = g_MachineStatus > STATUS_DISCONNECTED && (time - g_LastIdleTime > SHOW_STOP_TIME);
+	const bool bCanShowStop = g_MachineStatus > STATUS_DISCONNECTED && (time - g_LastIdleTime > SHOW_STOP_TIME);
+	if (g_bCanShowStop != bCanShowStop)
+	{
+		g_bCanShowStop = bCanShowStop;
+		StateChanged();
+	}
 
 	// read buttons
 #ifdef EMULATOR
 	uint16_t physicalButtons = g_PhysicalButtons;
 #else
-	uint16_t physicalButtons = ReadButtons();
+	uint16_t physicalButtons = GetButtonSnapshot();
 #endif
 	UpdateButtonState(physicalButtons, dt);
 	UpdateJoystick();
@@ -496,7 +1088,7 @@ void loop( void )
 	// check for Abort button
 	if (TestBit(g_ButtonClick, BUTTON_ABORT))
 	{
-		Serial.println(ROMSTR("ABORT"));
+		g_Port.SendRealtime(REALTIME_ABORT);
 		if (!bScreenSelected)
 		{
 			g_MainScreen.Activate(time);
@@ -513,24 +1105,57 @@ void loop( void )
 	// update current screen
 	BaseScreen::s_pCurrentScreen->Update(time);
 
-	// draw
-#if U8G2_FULL_BUFFER
-	BaseScreen::ClearScreen();
-	SetDrawColor(1);
-	BaseScreen::s_pCurrentScreen->Draw();
+	// send what fits in the Serial buffer. the rest waits for the next frame
+	g_Port.Update();
+
+	// draw. the input and the serial port are processed every iteration, but a frame is drawn only if something changed
 #if PARTIAL_SCREEN_UPDATE
-	BaseScreen::UpdateScreen();
+	// the previous frame is sent over several loop iterations, so the input doesn't wait for the whole screen.
+	// the next frame is drawn after it's done
+#if SCREEN_BENCHMARK
+	unsigned long benchTime = micros();
+	const bool bFlushed = FlushTiles();
+	g_BenchFlushTime += micros() - benchTime;
+	benchTime = micros();
 #else
-	u8g2_SendBuffer(&u8g2);
+	const bool bFlushed = FlushTiles();
 #endif
-#else
-	u8g2_FirstPage(&u8g2);
-	do
+	if (bFlushed && ShouldDrawFrame(time))
+	{
+		BaseScreen::ClearScreen();
+		SetDrawColor(1);
+		BaseScreen::s_pCurrentScreen->Draw();
+		BaseScreen::UpdateScreen();
+#if SCREEN_BENCHMARK
+		g_BenchDrawTime += micros() - benchTime;
+		g_BenchFrames++;
+#endif
+	}
+#if SCREEN_BENCHMARK
+	if (g_bConnected)
 	{
+		SendBenchmark(time);
+	}
+#endif
+#elif U8G2_FULL_BUFFER
+	if (ShouldDrawFrame(time))
+	{
+		BaseScreen::ClearScreen();
 		SetDrawColor(1);
 		BaseScreen::s_pCurrentScreen->Draw();
+		u8g2_SendBuffer(&u8g2);
+	}
+#else
+	if (ShouldDrawFrame(time))
+	{
+		u8g2_FirstPage(&u8g2);
+		do
+		{
+			SetDrawColor(1);
+			BaseScreen::s_pCurrentScreen->Draw();
+		}
+		while (u8g2_NextPage(&u8g2));
 	}
-	while (u8g2_NextPage(&u8g2));
 #endif
 
 #ifndef EMULATOR
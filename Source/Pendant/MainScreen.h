@@ -1,81 +1,56 @@
 DEFINE_STRING(g_StrJob, "Job>");
 
+const WidgetLayout MainScreen::s_Layout[WIDGET_COUNT] PROGMEM =
+{
+	{WIDGET_STATUS, 0, 0},
+	{WIDGET_COORD, 2, 1},
+	{WIDGET_COORD, 2, 2},
+	{WIDGET_COORD, 2, 3},
+	{WIDGET_BUTTON, BUTTON_HOME, 0},
+	{WIDGET_BUTTON, BUTTON_WCS, 0},
+	{WIDGET_BUTTON, BUTTON_PROBE, 0},
+	{WIDGET_BUTTON, BUTTON_JOB, 0},
+	{WIDGET_BUTTON, BUTTON_MACROS, 0},
+};
+
 void MainScreen::Draw( void )
 {
-#if PARTIAL_SCREEN_UPDATE
-	DrawState *pDrawState = reinterpret_cast<DrawState*>(s_DrawState.custom);
-	const bool bDrawAll = s_DrawState.bDrawAll || pDrawState->bWorkSpace != g_bWorkSpace || pDrawState->bShowInches != g_bShowInches ||
-		pDrawState->bCanShowStop != g_bCanShowStop || pDrawState->bJobRunning != g_bJobRunning;
-	pDrawState->bWorkSpace = g_bWorkSpace;
-	pDrawState->bShowInches = g_bShowInches;
-	pDrawState->bCanShowStop = g_bCanShowStop;
-	pDrawState->bJobRunning = g_bJobRunning;
-	if (bDrawAll && !s_DrawState.bDrawAll)
+	SetText(WIDGET_STATUS_LINE, ROMSTR("MAIN"), 4);
+	SetCoord(WIDGET_X, g_StrX, GetDisplayX(), false);
+	SetCoord(WIDGET_Y, g_StrY, GetDisplayY(), false);
+	SetCoord(WIDGET_Z, g_StrZ, GetDisplayZ(), false);
+
+	SetText(WIDGET_WCS, g_bWorkSpace ? g_StrWCS : g_StrMCS, 5);
+	if (g_MachineStatus == STATUS_IDLE)
 	{
-		ClearBuffer();
+		SetText(WIDGET_PROBE, ROMSTR("Probe>"), 6);
+		SetText(WIDGET_JOB, g_StrJob, 4);
+		SetText(WIDGET_MACROS, ROMSTR("Macros>"), 7);
+		SetText(WIDGET_HOME, ROMSTR("Home"), 4, true);
 	}
-
-	const bool bDrawX = bDrawAll || pDrawState->wx != g_WorkX || pDrawState->ox != g_OffsetX;
-	const bool bDrawY = bDrawAll || pDrawState->wy != g_WorkY || pDrawState->oy != g_OffsetY;
-	const bool bDrawZ = bDrawAll || pDrawState->wz != g_WorkZ || pDrawState->oz != g_OffsetZ;
-	pDrawState->wx = g_WorkX;
-	pDrawState->ox = g_OffsetX;
-	pDrawState->wy = g_WorkY;
-	pDrawState->oy = g_OffsetY;
-	pDrawState->wz = g_WorkZ;
-	pDrawState->oz = g_OffsetZ;
-#else
-	const bool bDrawX = true, bDrawY = true, bDrawZ = true, bDrawAll = true;
-#endif
-
-	if (bDrawAll)
+	else
 	{
-		DrawMachineStatus(ROMSTR("MAIN"), 4);
-		DrawText(0, 1, g_StrX);
-		DrawText(0, 2, g_StrY);
-		DrawText(0, 3, g_StrZ);
-
-		DrawButton(BUTTON_WCS, g_bWorkSpace ? g_StrWCS : g_StrMCS, 5, false);
-		if (g_MachineStatus == STATUS_IDLE)
+		if (g_bCanShowStop)
 		{
-			DrawButton(BUTTON_PROBE, ROMSTR("Probe>"), 6, false);
-			DrawButton(BUTTON_JOB, g_StrJob, 4, false);
-			DrawButton(BUTTON_MACROS, ROMSTR("Macros>"), 7, false);
-			DrawButton(BUTTON_HOME, ROMSTR("Home"), 4, true);
+			SetText(WIDGET_PROBE, g_StrSTOP, 4);
 		}
 		else
 		{
-			uint8_t unusedButtons = 0xE8;
-			if (g_bCanShowStop)
-			{
-				DrawButton(BUTTON_STOP, g_StrSTOP, 4, false);
-				unusedButtons &= ~(1 << BUTTON_STOP);
-			}
-			if (g_bJobRunning)
-			{
-				DrawButton(BUTTON_JOB, g_StrJob, 4, false);
-				unusedButtons &= ~(1 << BUTTON_JOB);
-			}
-			DrawUnusedButtons(unusedButtons);
+			SetUnused(WIDGET_PROBE);
 		}
+		if (g_bJobRunning)
+		{
+			SetText(WIDGET_JOB, g_StrJob, 4);
+		}
+		else
+		{
+			SetUnused(WIDGET_JOB);
+		}
+		SetUnused(WIDGET_MACROS);
+		SetUnused(WIDGET_HOME);
 	}
 
-	SetDrawColor(1);
-	if (bDrawX)
-	{
-		PrintX(g_TextBuf);
-		DrawText(2, 1, g_TextBuf);
-	}
-	if (bDrawY)
-	{
-		PrintY(g_TextBuf);
-		DrawText(2, 2, g_TextBuf);
-	}
-	if (bDrawZ)
-	{
-		PrintZ(g_TextBuf);
-		DrawText(2, 3, g_TextBuf);
-	}
+	DrawWidgets(s_Layout, WIDGET_COUNT);
 }
 
 void MainScreen::Update( unsigned long time )
@@ -109,7 +84,7 @@ void MainScreen::Update( unsigned long time )
 		}
 		else if (TestBit(g_ButtonHold, BUTTON_HOME))
 		{
-			Serial.println(ROMSTR("HOME"));
+			g_Port.println(ROMSTR("HOME"));
 		}
 		else if (button == BUTTON_PROBE)
 		{
@@ -124,7 +99,7 @@ void MainScreen::Update( unsigned long time )
 		}
 		else if (button == BUTTON_JOB)
 		{
-			Serial.println(ROMSTR("JOBMENU"));
+			g_Port.println(ROMSTR("JOBMENU"));
 		}
 		else if (button == BUTTON_MACROS)
 		{
@@ -135,7 +110,7 @@ void MainScreen::Update( unsigned long time )
 	}
 	else if (g_bCanShowStop && button == BUTTON_STOP)
 	{
-		Serial.println(g_StrSTOP);
+		g_Port.SendRealtime(REALTIME_STOP);
 	}
 	else if (g_bJobRunning && button == BUTTON_JOB)
 	{
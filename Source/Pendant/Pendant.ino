@@ -1,18 +1,25 @@
 #include <Arduino.h>
+#include "Config.h"
+#if BUILTIN_DISPLAY_DRIVER
+#include <Wire.h>
+#include "SSD1309.h"
+#else
 #include <U8g2lib.h>
+#endif
 #include <EEPROM.h>
 #if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega4808__) || defined(__AVR_ATmega4809__)
 #include <avr/wdt.h>
 #elif defined(ARDUINO_NANO_R4)
 #include <WDT.h>
+#include <FspTimer.h>
+#include <r_adc.h>
 #endif
 
-#ifdef U8X8_HAVE_HW_I2C
+#if !BUILTIN_DISPLAY_DRIVER && defined(U8X8_HAVE_HW_I2C)
 #include <Wire.h>
 #endif
 
 void InitializeInput( void );
-uint16_t ReadButtons( void );
 
 #define Sprintf sprintf
 #define Strlen strlen
@@ -31,22 +38,185 @@ const uint8_t g_ButtonPins[] PROGMEM = {A3, A2, A1, A0, 7, 8, 9, 10, 12, 6};
 
 static_assert(sizeof(g_ButtonPins) == BUTTON_COUNT, "wrong button count");
 
+const volatile PinRegisterType *g_ButtonRegisters[BUTTON_COUNT];
+PinRegisterType g_ButtonBitmasks[BUTTON_COUNT];
+
+void StartButtonTimer( void );
+void StartJoystickADC( void );
+
 void InitializeInput( void )
 {
 	for (uint16_t i = 0; i < BUTTON_COUNT; i++)
 	{
-		pinMode(pgm_read_byte(&g_ButtonPins[i]), INPUT_PULLUP);
+		const uint8_t pin = pgm_read_byte(&g_ButtonPins[i]);
+		pinMode(pin, INPUT_PULLUP);
+		g_ButtonRegisters[i] = portInputRegister(digitalPinToPort(pin));
+		g_ButtonBitmasks[i] = digitalPinToBitMask(pin);
 	}
 	pinMode(g_JoyPinX, INPUT);
 	pinMode(g_JoyPinY, INPUT);
+	StartJoystickADC();
+	StartButtonTimer();
 }
 
+// Reads the raw state of the buttons from the port registers. Called from the timer interrupt
 uint16_t ReadButtons( void )
 {
 	uint16_t buttons = 0;
-	for (uint16_t i = 0; i < BUTTON_COUNT; i++)
+	for (uint8_t i = 0; i < BUTTON_COUNT; i++)
 	{
-		if (digitalRead(pgm_read_byte(&g_ButtonPins[i])) == LOW) buttons |= 1 << i;
+		if (!(*g_ButtonRegisters[i] & g_ButtonBitmasks[i])) buttons |= 1 << i;
 	}
 	return buttons;
 }
+
+#if defined(__AVR_ATmega328P__)
+
+// Timer0 already overflows every 1.024ms for millis(). Its compare A interrupt is unused and fires at the same rate
+ISR(TIMER0_COMPA_vect)
+{
+	ScanButtons(ReadButtons());
+}
+
+void StartButtonTimer( void )
+{
+	OCR0A = 0x80;
+	TIMSK0 |= _BV(OCIE0A);
+}
+
+// Each conversion is started when the previous one completes, switching between X and Y. With the 125kHz ADC clock
+// that's about 4800 samples per second for each axis
+ISR(ADC_vect)
+{
+	const uint16_t sample = ADC;
+	const uint8_t axis = g_JoyAdcAxis;
+	g_JoyAdcAxis = axis ^ 1;
+	ADMUX = _BV(REFS0) | ((axis ? g_JoyPinX : g_JoyPinY) - A0);
+	ADCSRA |= _BV(ADSC);
+	FilterJoystick(axis, sample);
+}
+
+void StartJoystickADC( void )
+{
+	ADMUX = _BV(REFS0) | (g_JoyPinX - A0); // AVcc reference
+	ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+}
+
+#elif defined(__AVR_ATmega4808__) || defined(__AVR_ATmega4809__)
+
+// TCB1 is free - it is only used for PWM on D3, which is an encoder input
+ISR(TCB1_INT_vect)
+{
+	TCB1.INTFLAGS = TCB_CAPT_bm;
+	ScanButtons(ReadButtons());
+}
+
+void StartButtonTimer( void )
+{
+	TCB1.CCMP = F_CPU / 1000 - 1;
+	TCB1.CTRLB = TCB_CNTMODE_INT_gc; // periodic interrupt
+	TCB1.INTCTRL = TCB_CAPT_bm;
+	TCB1.CTRLA = TCB_CLKSEL_CLKDIV1_gc | TCB_ENABLE_bm;
+}
+
+// Each result is the sum of 4 samples, accumulated by the ADC. The next conversion is started when the previous one
+// completes, switching between X and Y - about 1000 results per second for each axis
+ISR(ADC0_RESRDY_vect)
+{
+	const uint16_t sample = ADC0.RES; // also clears the interrupt flag
+	const uint8_t axis = g_JoyAdcAxis;
+	g_JoyAdcAxis = axis ^ 1;
+	ADC0.MUXPOS = digitalPinToAnalogInput(axis ? g_JoyPinX : g_JoyPinY);
+	ADC0.COMMAND = ADC_STCONV_bm;
+	FilterJoystick(axis, sample);
+}
+
+void StartJoystickADC( void )
+{
+	ADC0.CTRLA = 0;
+	ADC0.CTRLB = ADC_SAMPNUM_ACC4_gc;
+	ADC0.CTRLC = ADC_SAMPCAP_bm | ADC_REFSEL_VDDREF_gc | ADC_PRESC_DIV128_gc;
+	ADC0.MUXPOS = digitalPinToAnalogInput(g_JoyPinX);
+	ADC0.INTCTRL = ADC_RESRDY_bm;
+	ADC0.CTRLA = ADC_ENABLE_bm; // 10-bit resolution
+	ADC0.COMMAND = ADC_STCONV_bm;
+}
+
+#elif defined(ARDUINO_NANO_R4)
+
+FspTimer g_ButtonTimer;
+
+adc_instance_ctrl_t g_JoyAdcCtrl;
+adc_channel_t g_JoyAdcChannels[2]; // X and Y
+
+// The ADC scans X and Y continuously (see StartJoystickADC), so the 1kHz button interrupt only picks up the latest
+// results from the result registers
+void ButtonTimerCallback( timer_callback_args_t *args )
+{
+	ScanButtons(ReadButtons());
+	for (uint8_t axis = 0; axis < 2; axis++)
+	{
+		uint16_t sample;
+		R_ADC_Read(&g_JoyAdcCtrl, g_JoyAdcChannels[axis], &sample);
+		FilterJoystick(axis, sample);
+	}
+}
+
+void StartButtonTimer( void )
+{
+	uint8_t type;
+	int8_t channel = FspTimer::get_available_timer(type);
+	if (channel < 0)
+	{
+		channel = FspTimer::get_available_timer(type, true); // take one of the PWM timers
+	}
+	g_ButtonTimer.begin(TIMER_MODE_PERIODIC, type, channel, 1000.0f, 0.0f, ButtonTimerCallback);
+	g_ButtonTimer.setup_overflow_irq();
+	g_ButtonTimer.open();
+	g_ButtonTimer.start();
+}
+
+// Returns the ADC channel of an analog pin, and switches the pin to analog mode
+adc_channel_t GetAdcChannel( int pin )
+{
+	const std::array<uint16_t, 3> cfg = getPinCfgs(pin, PIN_CFG_REQ_ADC);
+	R_IOPORT_PinCfg(&g_ioport_ctrl, g_pin_cfg[pin].pin, IOPORT_CFG_ANALOG_ENABLE);
+	return (adc_channel_t)GET_CHANNEL(cfg[0]);
+}
+
+// Sets up the ADC once to scan X and Y continuously at 14 bits, averaging 4 samples in hardware. analogRead must not be
+// used after this, as it would reconfigure the ADC
+void StartJoystickADC( void )
+{
+	g_JoyAdcChannels[0] = GetAdcChannel(g_JoyPinX);
+	g_JoyAdcChannels[1] = GetAdcChannel(g_JoyPinY);
+
+	static adc_extended_cfg_t s_Extend;
+	s_Extend.add_average_count = ADC_ADD_AVERAGE_FOUR;
+	s_Extend.clearing = ADC_CLEAR_AFTER_READ_OFF;
+	s_Extend.trigger = ADC_START_SOURCE_DISABLED; // software trigger
+	s_Extend.trigger_group_b = ADC_START_SOURCE_DISABLED;
+	s_Extend.double_trigger_mode = ADC_DOUBLE_TRIGGER_DISABLED;
+	s_Extend.adc_vref_control = ADC_VREF_CONTROL_AVCC0_AVSS0;
+	s_Extend.window_a_irq = FSP_INVALID_VECTOR;
+	s_Extend.window_b_irq = FSP_INVALID_VECTOR;
+
+	static adc_cfg_t s_Config;
+	s_Config.unit = 0;
+	s_Config.mode = ADC_MODE_CONTINUOUS_SCAN;
+	s_Config.resolution = ADC_RESOLUTION_14_BIT;
+	s_Config.alignment = ADC_ALIGNMENT_RIGHT;
+	s_Config.scan_end_irq = FSP_INVALID_VECTOR; // no interrupts, the results are read from the button timer
+	s_Config.scan_end_b_irq = FSP_INVALID_VECTOR;
+	s_Config.p_extend = &s_Extend;
+
+	static adc_channel_cfg_t s_Channels;
+	s_Channels.scan_mask = (1UL << g_JoyAdcChannels[0]) | (1UL << g_JoyAdcChannels[1]);
+	s_Channels.add_mask = s_Channels.scan_mask;
+
+	R_ADC_Open(&g_JoyAdcCtrl, &s_Config);
+	R_ADC_ScanCfg(&g_JoyAdcCtrl, &s_Channels);
+	R_ADC_ScanStart(&g_JoyAdcCtrl);
+}
+
+#endif
@@ -4,10 +4,10 @@ void ProbeMenuScreen::Draw( void )
 	DrawState *pDrawState = reinterpret_cast<DrawState*>(s_DrawState.custom);
 	const bool bDrawAll = s_DrawState.bDrawAll || pDrawState->probeState != g_ProbeState;
 	pDrawState->probeState = g_ProbeState;
-	if (!bDrawAll) return;
-	if (!s_DrawState.bDrawAll)
+	if (!bDrawAll && !HasDirtyRegions()) return;
+	if (bDrawAll && !s_DrawState.bDrawAll)
 	{
-		ClearBuffer();
+		RedrawAll();
 	}
 #endif
 
@@ -42,9 +42,9 @@ void ProbeMenuScreen::Update( unsigned long time )
 		}
 		else
 		{
-			Serial.print(g_StrPROBE2);
-			Serial.print(g_StrENTER);
-			Serial.println(ZProbeScreen::PROBE_REF_TOOL);
+			g_Port.print(g_StrPROBE2);
+			g_Port.print(g_StrENTER);
+			g_Port.println(ZProbeScreen::PROBE_REF_TOOL);
 		}
 	}
 	else if ((g_ProbeState & PROBE_TLO_HAS_REF) && button == BUTTON_PROBE_NEW_TOOL)
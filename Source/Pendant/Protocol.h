@@ -0,0 +1,732 @@
+#pragma once
+
+// Communication with the PC
+//
+// The connection always starts with the ASCII protocol - each command is a line of text terminated by \n.
+// After the PEN/DANT handshake the PC can send PROTO:B to switch to the binary protocol. If the pendant supports it
+// it responds with PROTO:B (otherwise PROTO:A), and from then on both sides send binary frames:
+//   <type> <payload> <crc16>
+// The CRC is CRC-16/CCITT (poly 0x1021, init 0xFFFF) of the type and payload, little-endian. The whole frame is
+// COBS-encoded and terminated by a 0 byte. All multi-byte values are little-endian.
+// The binary mode lasts until the next PEN or BYE
+//
+// Flow control: the ASCII protocol waits for an ACK after every line or 50-byte chunk. In binary mode the PC keeps
+// sending frames as long as they fit in the receive window advertised in the PROTO:B<window> response. Every frame
+// from the pendant ends with a credit byte (before the CRC) - the number of bytes received so far, modulo 256. The PC
+// uses the difference from the previous credit to free up the window. If the pendant has nothing else to send, it
+// sends FRAME_CREDIT
+//
+// Realtime codes: the commands that must not wait behind other messages (abort, stop, etc.) are sent to the PC as
+// single bytes 0x80-0x84. In ASCII mode they can appear anywhere in the stream, even in the middle of a line. In binary
+// mode they are sent between frames as <code> 0 - a 1-byte frame is too short to be a valid frame. The pendant uses
+// them only if the PC sent PROTO: (either mode), otherwise it sends the equivalent text commands
+
+enum FrameType
+{
+	// both directions
+	FRAME_TEXT = 1, // ASCII command, without the \n
+	FRAME_TEXT_PART = 2, // partial ASCII command, more will follow in the next frames
+
+	// PC -> pendant
+	FRAME_STATUS = 16, // see ParseStatusFrame
+	FRAME_STATUS2 = 17, // see ParseStatus2Frame
+	FRAME_PONG = 18,
+	FRAME_STATUS_DELTA = 19, // see ParseStatusDeltaFrame
+
+	// pendant -> PC
+	FRAME_CREDIT = 32, // only the credit byte
+	FRAME_PING = 33,
+	FRAME_JOG_XY = 34, // <x:i8> <y:i8>
+	FRAME_JOG_WHEEL = 35, // <I/M> <axis> <count:i16> <step:u16> - the step is in 1/1000 inch or 1/100 mm
+	FRAME_RAWJOY = 36, // <x:u16> <y:u16>
+	FRAME_RESYNC = 37, // a status update was missed. the PC must send a full FRAME_STATUS
+};
+
+enum RealtimeCode
+{
+	REALTIME_ABORT = 0x80, // ABORT
+	REALTIME_STOP = 0x81, // STOP
+	REALTIME_JOB_STOP = 0x82, // JOB:STOP
+	REALTIME_FEED_HOLD = 0x83, // JOB:PAUSE
+	REALTIME_JOG_CANCEL = 0x84, // JOG:JXY0,0
+};
+
+const uint8_t MAX_FRAME_SIZE = 64; // max encoded size of a frame, without the 0 delimiter
+const uint8_t FRAME_OVERHEAD = 3; // type + crc16
+const uint8_t RX_WINDOW = 60; // how many bytes the PC can send ahead. must fit in the Serial receive buffer (64 bytes on AVR)
+
+bool g_bRealtimeCodes; // the PC supports the realtime codes
+
+#if USE_BINARY_PROTOCOL
+bool g_bBinaryMode;
+uint8_t g_RxCount; // number of bytes received in binary mode, modulo 256. sent to the PC as credit
+uint8_t g_RxCountSent; // the last credit sent to the PC
+#else
+const bool g_bBinaryMode = false;
+#endif
+
+uint16_t Crc16( const uint8_t *data, uint8_t len )
+{
+	uint16_t crc = 0xFFFF;
+	for (uint8_t i = 0; i < len; i++)
+	{
+		crc ^= (uint16_t)data[i] << 8;
+		for (uint8_t b = 0; b < 8; b++)
+		{
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+		}
+	}
+	return crc;
+}
+
+uint16_t ReadUint16( const uint8_t *data )
+{
+	return data[0] | ((uint16_t)data[1] << 8);
+}
+
+int32_t ReadInt32( const uint8_t *data )
+{
+	return (int32_t)(data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24));
+}
+
+void WriteUint16( uint8_t *data, uint16_t value )
+{
+	data[0] = (uint8_t)value;
+	data[1] = (uint8_t)(value >> 8);
+}
+
+#if USE_BINARY_PROTOCOL
+// COBS-encodes the data and adds the 0 delimiter. dst must have room for len + 2 bytes. Returns the encoded size
+uint8_t CobsEncode( const uint8_t *src, uint8_t len, uint8_t *dst )
+{
+	Assert(len < 254); // the frames are short, so the code never reaches 0xFF
+	uint8_t codeIdx = 0;
+	uint8_t code = 1;
+	uint8_t out = 1;
+	for (uint8_t i = 0; i < len; i++)
+	{
+		if (src[i] == 0)
+		{
+			dst[codeIdx] = code;
+			codeIdx = out++;
+			code = 1;
+		}
+		else
+		{
+			dst[out++] = src[i];
+			code++;
+		}
+	}
+	dst[codeIdx] = code;
+	dst[out++] = 0;
+	return out;
+}
+
+// Reads a zigzag-encoded varint and advances the pointer. Returns false if the data ends prematurely
+bool ReadZigzag( const uint8_t *&data, const uint8_t *end, int32_t &value )
+{
+	uint32_t v = 0;
+	for (uint8_t shift = 0; shift < 35; shift += 7)
+	{
+		if (data >= end)
+		{
+			return false;
+		}
+		uint8_t b = *data++;
+		v |= (uint32_t)(b & 0x7F) << shift;
+		if (!(b & 0x80))
+		{
+			value = (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+			return true;
+		}
+	}
+	return false;
+}
+
+// Decodes a COBS frame in place (without the 0 delimiter). Returns the decoded size, or 0 if the frame is malformed
+uint8_t CobsDecode( uint8_t *data, uint8_t len )
+{
+	uint8_t in = 0;
+	uint8_t out = 0;
+	while (in < len)
+	{
+		uint8_t code = data[in++];
+		if (code == 0 || in + code - 1 > len)
+		{
+			return 0;
+		}
+		for (uint8_t i = 1; i < code; i++)
+		{
+			data[out++] = data[in++];
+		}
+		if (code < 0xFF && in < len)
+		{
+			data[out++] = 0;
+		}
+	}
+	return out;
+}
+#endif
+
+// Sends messages to the PC. The text is collected until println, then it is queued as a line or as a FRAME_TEXT,
+// depending on the protocol mode. Update sends the queue without blocking, as much as fits in the Serial transmit
+// buffer. Use it instead of Serial for everything after the handshake
+class PendantPort
+{
+public:
+	void print( const char *str );
+#ifndef EMULATOR
+	void print( const __FlashStringHelper *str );
+#endif
+	void print( int value );
+	void print( unsigned int value );
+	void print( unsigned long value );
+
+	template<typename T> void println( T value ) { print(value); println(); }
+	void println( void ) { QueueLine(false); }
+
+	// for safety messages (STOP, ABORT). they are sent ahead of everything else in the queue
+	template<typename T> void UrgentPrintln( T value ) { print(value); QueueLine(true); }
+
+	// typed messages. they are sent as ASCII commands when not in binary mode
+	// while the link is busy, a newer SendJogXY or SendRawJoy replaces the queued one, and SendJogWheel for the same
+	// axis and step is added to the queued one
+	void SendPing( void );
+	void SendJogXY( int8_t x, int8_t y );
+	void SendJogWheel( int16_t count, char axis, uint16_t step, bool bInches );
+	void SendRawJoy( uint16_t x, uint16_t y );
+	void SendAck( void ); // ASCII mode only
+
+	// sends a realtime code immediately, or the equivalent text command if the PC doesn't support them
+	void SendRealtime( RealtimeCode code );
+
+#if USE_BINARY_PROTOCOL
+	void SendFrame( uint8_t type, const uint8_t *payload, uint8_t len, bool bUrgent = false );
+	void SendCredit( void );
+#endif
+
+	void Update( void ); // sends as much of the queue as possible without blocking
+	void Flush( void ); // sends everything and waits until it is transmitted
+	void Reset( void ); // drops all unsent messages
+
+private:
+	enum
+	{
+		PENDING_JOG_XY = 1,
+		PENDING_JOG_WHEEL = 2,
+		PENDING_RAWJOY = 4,
+	};
+
+	void Append( char ch );
+	void PrintNumber( unsigned long value, bool bNegative );
+	void QueueLine( bool bUrgent );
+	void Queue( const uint8_t *data, uint8_t len, bool bUrgent );
+	bool QueueMessage( const uint8_t *data, uint8_t len, uint8_t reserve = 0 );
+	bool QueueHeld( void );
+	void QueuePending( void );
+#if USE_BINARY_PROTOCOL
+	uint8_t EncodeFrame( uint8_t type, const uint8_t *payload, uint8_t len, bool bUrgent, uint8_t *encoded );
+#endif
+
+	char m_Line[MAX_FRAME_SIZE - FRAME_OVERHEAD - 3];
+	uint8_t m_LineLen;
+
+	// the queued messages, each prefixed with its size
+	uint8_t m_Queue[PENDANT_TX_QUEUE_SIZE];
+	uint8_t m_QueueStart;
+	uint8_t m_QueueSize;
+	uint8_t m_MessageLeft; // unsent bytes of the message at m_QueueStart. other messages can't be sent before it's done
+
+	// the coalesced messages leave this much of the queue free, so the commands from the screens don't have to wait
+	enum { COMMAND_RESERVE = 24 };
+
+	// the regular messages that didn't fit in the queue. they go in before anything else once there is room. each is
+	// prefixed with its size and, in binary mode, the credit encoded in the frame
+#if USE_BINARY_PROTOCOL
+	enum { HELD_HEADER = 2 };
+#else
+	enum { HELD_HEADER = 1 };
+#endif
+	uint8_t m_Held[MAX_FRAME_SIZE * 3 / 2];
+	uint8_t m_HeldSize;
+
+	// the urgent messages, each prefixed with its size. room for two of the longest ones
+	uint8_t m_Urgent[40];
+	uint8_t m_UrgentStart;
+	uint8_t m_UrgentSize;
+	uint8_t m_UrgentLeft; // unsent bytes of the urgent message at m_UrgentStart
+
+#if USE_BINARY_PROTOCOL
+	uint8_t m_FrameCredit; // the credit in the last encoded regular frame. it counts as sent once the frame is queued
+#endif
+
+	// coalesced messages, not queued yet
+	uint8_t m_Pending;
+	int8_t m_JogX, m_JogY;
+	uint16_t m_RawX, m_RawY;
+	int16_t m_WheelCount;
+	char m_WheelAxis;
+	bool m_bWheelInches;
+	uint16_t m_WheelStep;
+};
+
+PendantPort g_Port;
+
+void PendantPort::Append( char ch )
+{
+	Assert(m_LineLen < sizeof(m_Line) - 2); // the longest message must fit. a longer one is sent truncated
+	if (m_LineLen < sizeof(m_Line) - 2) // leave room for \r\n
+	{
+		m_Line[m_LineLen++] = ch;
+	}
+}
+
+void PendantPort::print( const char *str )
+{
+	while (*str)
+	{
+		Append(*str++);
+	}
+}
+
+#ifndef EMULATOR
+void PendantPort::print( const __FlashStringHelper *str )
+{
+	const char *ptr = (const char*)str;
+	while (char ch = pgm_read_byte(ptr++))
+	{
+		Append(ch);
+	}
+}
+#endif
+
+void PendantPort::PrintNumber( unsigned long value, bool bNegative )
+{
+	char buf[11];
+	uint8_t len = 0;
+	do
+	{
+		buf[len++] = '0' + value % 10;
+		value /= 10;
+	} while (value);
+	if (bNegative)
+	{
+		Append('-');
+	}
+	while (len > 0)
+	{
+		Append(buf[--len]);
+	}
+}
+
+void PendantPort::print( int value )
+{
+	PrintNumber(value < 0 ? -(long)value : value, value < 0);
+}
+
+void PendantPort::print( unsigned int value )
+{
+	PrintNumber(value, false);
+}
+
+void PendantPort::print( unsigned long value )
+{
+	PrintNumber(value, false);
+}
+
+void PendantPort::QueueLine( bool bUrgent )
+{
+	uint8_t len = m_LineLen;
+	m_LineLen = 0;
+#if USE_BINARY_PROTOCOL
+	if (g_bBinaryMode)
+	{
+		SendFrame(FRAME_TEXT, (const uint8_t*)m_Line, len, bUrgent);
+		return;
+	}
+#endif
+	m_Line[len++] = '\r';
+	m_Line[len++] = '\n';
+	Queue((const uint8_t*)m_Line, len, bUrgent);
+}
+
+// Adds a message to the queue. The regular messages are sent in order, after any coalesced messages that came before.
+// Never waits for the link. If the queue is full, a regular message is held and Update queues it once there is room.
+// It is dropped only if the held messages fill up too - then the PC hasn't read anything for a while and the link is
+// about to time out. An urgent message always fits
+void PendantPort::Queue( const uint8_t *data, uint8_t len, bool bUrgent )
+{
+	if (!bUrgent)
+	{
+		QueuePending();
+		if (m_HeldSize == 0 && QueueMessage(data, len))
+		{
+			return;
+		}
+		Assert(len + HELD_HEADER <= sizeof(m_Held));
+		if (m_HeldSize + len + HELD_HEADER > sizeof(m_Held))
+		{
+			return;
+		}
+		m_Held[m_HeldSize] = len;
+#if USE_BINARY_PROTOCOL
+		m_Held[m_HeldSize + 1] = m_FrameCredit;
+#endif
+		memcpy(m_Held + m_HeldSize + HELD_HEADER, data, len);
+		m_HeldSize += len + HELD_HEADER;
+		return;
+	}
+
+	Assert(len < sizeof(m_Urgent) / 2);
+	if (m_UrgentSize + len + 1 > sizeof(m_Urgent))
+	{
+		// make room
+		m_UrgentSize -= m_UrgentStart;
+		memmove(m_Urgent, m_Urgent + m_UrgentStart, m_UrgentSize);
+		m_UrgentStart = 0;
+	}
+	if (m_UrgentSize + len + 1 > sizeof(m_Urgent))
+	{
+		// still full. the same message may be waiting already
+		for (uint8_t pos = m_UrgentLeft; pos < m_UrgentSize; pos += m_Urgent[pos] + 1)
+		{
+			if (m_Urgent[pos] == len && memcmp(m_Urgent + pos + 1, data, len) == 0)
+			{
+				return;
+			}
+		}
+		// otherwise the newest one wins. drop the waiting messages, but finish the one that is being sent
+		m_UrgentSize = m_UrgentLeft;
+	}
+	m_Urgent[m_UrgentSize] = len;
+	memcpy(m_Urgent + m_UrgentSize + 1, data, len);
+	m_UrgentSize += len + 1;
+}
+
+// Adds a regular message to the queue, leaving at least reserve bytes free. Returns false if there is no room
+bool PendantPort::QueueMessage( const uint8_t *data, uint8_t len, uint8_t reserve )
+{
+	Assert(len < sizeof(m_Queue));
+	if (m_QueueSize + len + 1 + reserve > sizeof(m_Queue))
+	{
+		return false;
+	}
+#if USE_BINARY_PROTOCOL
+	if (g_bBinaryMode)
+	{
+		g_RxCountSent = m_FrameCredit;
+	}
+#endif
+	uint8_t pos = (uint8_t)(((uint16_t)m_QueueStart + m_QueueSize) % sizeof(m_Queue)); // the sum can exceed 255
+	m_Queue[pos] = len;
+	for (uint8_t i = 0; i < len; i++)
+	{
+		if (++pos == sizeof(m_Queue)) pos = 0;
+		m_Queue[pos] = data[i];
+	}
+	m_QueueSize += len + 1;
+	return true;
+}
+
+// Moves the held messages to the queue, in order. Returns false if some are still held
+bool PendantPort::QueueHeld( void )
+{
+	while (m_HeldSize > 0)
+	{
+		const uint8_t len = m_Held[0];
+#if USE_BINARY_PROTOCOL
+		const uint8_t credit = m_FrameCredit;
+		m_FrameCredit = m_Held[1]; // newer frames may have been encoded since
+		if (!QueueMessage(m_Held + HELD_HEADER, len))
+		{
+			m_FrameCredit = credit;
+			return false;
+		}
+#else
+		if (!QueueMessage(m_Held + HELD_HEADER, len))
+		{
+			return false;
+		}
+#endif
+		m_HeldSize -= len + HELD_HEADER;
+		memmove(m_Held, m_Held + len + HELD_HEADER, m_HeldSize);
+	}
+	return true;
+}
+
+// Moves the coalesced messages to the queue, after the held messages. The ones that don't fit stay pending
+void PendantPort::QueuePending( void )
+{
+	const uint8_t pending = m_Pending;
+	if (!QueueHeld() || !pending)
+	{
+		return;
+	}
+	char buf[MAX_FRAME_SIZE];
+	uint8_t len;
+	if (pending & PENDING_JOG_XY)
+	{
+#if USE_BINARY_PROTOCOL
+		if (g_bBinaryMode)
+		{
+			uint8_t payload[2] = {(uint8_t)m_JogX, (uint8_t)m_JogY};
+			len = EncodeFrame(FRAME_JOG_XY, payload, 2, false, (uint8_t*)buf);
+		}
+		else
+#endif
+		{
+			len = Sprintf(buf, "JOG:JXY%d,%d\r\n", m_JogX, m_JogY);
+		}
+		if (QueueMessage((const uint8_t*)buf, len, COMMAND_RESERVE))
+		{
+			m_Pending &= ~PENDING_JOG_XY;
+		}
+	}
+	if (pending & PENDING_JOG_WHEEL)
+	{
+#if USE_BINARY_PROTOCOL
+		if (g_bBinaryMode)
+		{
+			uint8_t payload[6];
+			payload[0] = m_bWheelInches ? 'I' : 'M';
+			payload[1] = m_WheelAxis;
+			WriteUint16(payload + 2, (uint16_t)m_WheelCount);
+			WriteUint16(payload + 4, m_WheelStep);
+			len = EncodeFrame(FRAME_JOG_WHEEL, payload, 6, false, (uint8_t*)buf);
+		}
+		else
+#endif
+		if (m_bWheelInches)
+		{
+			len = Sprintf(buf, "JOG:WI%c%d*%d.%03d\r\n", m_WheelAxis, m_WheelCount, m_WheelStep/1000, m_WheelStep%1000);
+		}
+		else
+		{
+			len = Sprintf(buf, "JOG:WM%c%d*%d.%02d\r\n", m_WheelAxis, m_WheelCount, m_WheelStep/100, m_WheelStep%100);
+		}
+		if (QueueMessage((const uint8_t*)buf, len, COMMAND_RESERVE))
+		{
+			m_Pending &= ~PENDING_JOG_WHEEL;
+		}
+	}
+	if (pending & PENDING_RAWJOY)
+	{
+#if USE_BINARY_PROTOCOL
+		if (g_bBinaryMode)
+		{
+			uint8_t payload[4];
+			WriteUint16(payload, m_RawX);
+			WriteUint16(payload + 2, m_RawY);
+			len = EncodeFrame(FRAME_RAWJOY, payload, 4, false, (uint8_t*)buf);
+		}
+		else
+#endif
+		{
+			len = Sprintf(buf, "RAWJOY:%u,%u\r\n", m_RawX, m_RawY);
+		}
+		if (QueueMessage((const uint8_t*)buf, len, COMMAND_RESERVE))
+		{
+			m_Pending &= ~PENDING_RAWJOY;
+		}
+	}
+}
+
+void PendantPort::Update( void )
+{
+	QueueHeld();
+	uint16_t room = Serial.availableForWrite();
+	while (room > 0)
+	{
+		if (m_MessageLeft == 0)
+		{
+			// between messages. the urgent ones go first
+			if (m_UrgentLeft == 0 && m_UrgentStart < m_UrgentSize)
+			{
+				m_UrgentLeft = m_Urgent[m_UrgentStart++];
+			}
+			if (m_UrgentLeft > 0)
+			{
+				uint8_t len = m_UrgentLeft;
+				if (len > room) len = (uint8_t)room;
+				Serial.write(m_Urgent + m_UrgentStart, len);
+				m_UrgentStart += len;
+				m_UrgentLeft -= len;
+				room -= len;
+				if (m_UrgentStart == m_UrgentSize)
+				{
+					m_UrgentStart = m_UrgentSize = 0;
+				}
+				continue;
+			}
+			if (m_QueueSize == 0)
+			{
+				QueuePending(); // the link is idle, no need to wait for more updates
+				if (m_QueueSize == 0)
+				{
+					break;
+				}
+			}
+			m_MessageLeft = m_Queue[m_QueueStart];
+			if (++m_QueueStart == sizeof(m_Queue)) m_QueueStart = 0;
+			m_QueueSize--;
+		}
+
+		uint8_t len = m_MessageLeft;
+		if (len > room) len = (uint8_t)room;
+		if (len > sizeof(m_Queue) - m_QueueStart) len = sizeof(m_Queue) - m_QueueStart;
+		Serial.write(m_Queue + m_QueueStart, len);
+		m_QueueStart += len;
+		if (m_QueueStart == sizeof(m_Queue)) m_QueueStart = 0;
+		m_QueueSize -= len;
+		m_MessageLeft -= len;
+		room -= len;
+	}
+}
+
+void PendantPort::Flush( void )
+{
+	QueuePending();
+	while (m_QueueSize > 0 || m_UrgentSize > 0 || m_HeldSize > 0)
+	{
+		Update();
+	}
+	Serial.flush();
+}
+
+void PendantPort::Reset( void )
+{
+	m_LineLen = 0;
+	m_QueueStart = m_QueueSize = m_MessageLeft = 0;
+	m_HeldSize = 0;
+	m_UrgentStart = m_UrgentSize = m_UrgentLeft = 0;
+	m_Pending = 0;
+}
+
+#if USE_BINARY_PROTOCOL
+// Builds the encoded frame. The regular frames carry the current credit. The urgent frames can overtake the queued
+// ones, so they repeat the last sent credit
+uint8_t PendantPort::EncodeFrame( uint8_t type, const uint8_t *payload, uint8_t len, bool bUrgent, uint8_t *encoded )
+{
+	uint8_t frame[MAX_FRAME_SIZE - 2];
+	Assert(len + FRAME_OVERHEAD + 1 <= sizeof(frame));
+	frame[0] = type;
+	memcpy(frame + 1, payload, len);
+	if (!bUrgent)
+	{
+		m_FrameCredit = g_RxCount; // becomes the sent credit in QueueMessage, unless the frame stays pending
+	}
+	frame[len + 1] = bUrgent ? g_RxCountSent : m_FrameCredit; // piggyback the credit
+	WriteUint16(frame + len + 2, Crc16(frame, len + 2));
+	return CobsEncode(frame, len + FRAME_OVERHEAD + 1, encoded);
+}
+
+void PendantPort::SendFrame( uint8_t type, const uint8_t *payload, uint8_t len, bool bUrgent )
+{
+	if (!bUrgent)
+	{
+		QueuePending(); // must get its credit first
+	}
+	uint8_t encoded[MAX_FRAME_SIZE];
+	uint8_t size = EncodeFrame(type, payload, len, bUrgent, encoded);
+	Queue(encoded, size, bUrgent);
+}
+
+// Sends the credit for the received bytes, unless it was already sent with another frame. To reduce the traffic,
+// waits until all input is processed or half of the window is used up
+void PendantPort::SendCredit( void )
+{
+	uint8_t credit = g_RxCount - g_RxCountSent;
+	if (credit > 0 && (credit >= RX_WINDOW / 2 || Serial.available() == 0))
+	{
+		SendFrame(FRAME_CREDIT, NULL, 0);
+	}
+}
+#endif
+
+void PendantPort::SendPing( void )
+{
+#if USE_BINARY_PROTOCOL
+	if (g_bBinaryMode)
+	{
+		SendFrame(FRAME_PING, NULL, 0);
+		return;
+	}
+#endif
+	println(ROMSTR("PING"));
+}
+
+void PendantPort::SendJogXY( int8_t x, int8_t y )
+{
+	m_JogX = x;
+	m_JogY = y;
+	m_Pending |= PENDING_JOG_XY;
+}
+
+void PendantPort::SendJogWheel( int16_t count, char axis, uint16_t step, bool bInches )
+{
+	if (m_Pending & PENDING_JOG_WHEEL)
+	{
+		int32_t sum = (int32_t)m_WheelCount + count;
+		if (axis == m_WheelAxis && step == m_WheelStep && bInches == m_bWheelInches && sum >= -32768 && sum <= 32767)
+		{
+			m_WheelCount = (int16_t)sum;
+			return;
+		}
+		QueuePending(); // can't combine with the queued one
+		if (m_Pending & PENDING_JOG_WHEEL)
+		{
+			return; // the queue is full and the old clicks are still waiting. drop the new ones
+		}
+	}
+	m_WheelCount = count;
+	m_WheelAxis = axis;
+	m_WheelStep = step;
+	m_bWheelInches = bInches;
+	m_Pending |= PENDING_JOG_WHEEL;
+}
+
+void PendantPort::SendRawJoy( uint16_t x, uint16_t y )
+{
+	m_RawX = x;
+	m_RawY = y;
+	m_Pending |= PENDING_RAWJOY;
+}
+
+void PendantPort::SendAck( void )
+{
+	static const uint8_t ack[3] = {0x1F, '\r', '\n'};
+	Queue(ack, 3, true);
+}
+
+void PendantPort::SendRealtime( RealtimeCode code )
+{
+	if (code == REALTIME_JOG_CANCEL)
+	{
+		m_Pending &= ~PENDING_JOG_XY; // drop the outdated joystick position
+	}
+
+	if (!g_bRealtimeCodes)
+	{
+		switch (code)
+		{
+			case REALTIME_ABORT: UrgentPrintln(ROMSTR("ABORT")); break;
+			case REALTIME_STOP: UrgentPrintln(g_StrSTOP); break;
+			case REALTIME_JOB_STOP: print(g_StrJOB); UrgentPrintln(g_StrSTOP); break;
+			case REALTIME_FEED_HOLD: print(g_StrJOB); UrgentPrintln(ROMSTR("PAUSE")); break;
+			case REALTIME_JOG_CANCEL: SendJogXY(0, 0); break;
+		}
+		Update();
+		return;
+	}
+
+	uint8_t data[2] = {(uint8_t)code, 0};
+#if USE_BINARY_PROTOCOL
+	if (g_bBinaryMode)
+	{
+		Queue(data, 2, true); // goes out after the frame that is currently being sent
+		Update();
+		return;
+	}
+#endif
+	Serial.write(data, 1);
+}
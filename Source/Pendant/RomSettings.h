@@ -2,6 +2,7 @@
 
 const uint16_t SETTINGS_SIGNATURE = 37152;
 const char g_StrDefaultName[] PROGMEM = "Controlinator 3000";
+const uint8_t JOYSTICK_CURVE_POINTS = 8;
 
 // Persistent settings stored in the pendant's ROM
 struct RomSettings
@@ -12,6 +13,7 @@ struct RomSettings
 #if USE_WATCHDOG
 	uint8_t bCrash;
 #endif
+	uint8_t joyCurve[JOYSTICK_CURVE_POINTS]; // joystick response in % at 1/8, 2/8 ... 8/8 of the range. added later, so it's validated separately
 };
 
 const int SETTINGS_ROM_ADDRESS = 0;
@@ -19,6 +21,24 @@ RomSettings g_RomSettings;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Resets the joystick curve to linear if it doesn't go up to 100%, or if it ever goes down
+void ValidateJoystickCurve( void )
+{
+	uint8_t prev = 0;
+	for (uint8_t i = 0; i < JOYSTICK_CURVE_POINTS; i++)
+	{
+		if (g_RomSettings.joyCurve[i] < prev || (i == JOYSTICK_CURVE_POINTS - 1 && g_RomSettings.joyCurve[i] != 100))
+		{
+			for (i = 0; i < JOYSTICK_CURVE_POINTS; i++)
+			{
+				g_RomSettings.joyCurve[i] = ((i + 1) * 100 + JOYSTICK_CURVE_POINTS / 2) / JOYSTICK_CURVE_POINTS; // rounded, like the PC
+			}
+			return;
+		}
+		prev = g_RomSettings.joyCurve[i];
+	}
+}
+
 //Reads the settings from the ROM
 void ReadRomSettings( void )
 {
@@ -40,6 +60,7 @@ void ReadRomSettings( void )
 #endif
 		EEPROM.put(SETTINGS_ROM_ADDRESS, g_RomSettings);
 	}
+	ValidateJoystickCurve();
 }
 
 // Parses the NAME: string from the PC and stores the name in the ROM
@@ -52,16 +73,13 @@ void ParseName( const char *name )
 	EEPROM.put(SETTINGS_ROM_ADDRESS, g_RomSettings);
 }
 
-// Parses the CALIBRATION: string from the PC and stores the settings in the ROM
+// Parses the CALIBRATION: fields from the PC and stores the settings in the ROM
 // string format: <min x>,<max x>,<min deadx>,<max deadx>,<min y>,<max y>,<min deady>,<max deady>
-void ParseCalibration( const char *str )
+void ParseCalibration( char **fields )
 {
 	for (uint8_t i = 0; i < 8; i++)
 	{
-		g_RomSettings.calibration[i] = atoi(str);
-		const char *end = strchr(str, ',');
-		if (!end) break;
-		str = end + 1;
+		g_RomSettings.calibration[i] = atoi(fields[i]);
 	}
 
 	if (g_RomSettings.calibration[1] <= g_RomSettings.calibration[0])
@@ -80,3 +98,16 @@ void ParseCalibration( const char *str )
 
 	EEPROM.put(SETTINGS_ROM_ADDRESS, g_RomSettings);
 }
+
+// Parses the JOYCURVE: fields from the PC and stores the settings in the ROM
+// string format: <% at 1/8>,<% at 2/8>,...,<% at 8/8>
+void ParseJoystickCurve( char **fields )
+{
+	for (uint8_t i = 0; i < JOYSTICK_CURVE_POINTS; i++)
+	{
+		const int value = atoi(fields[i]);
+		g_RomSettings.joyCurve[i] = value < 0 ? 0 : value > 100 ? 100 : value;
+	}
+	ValidateJoystickCurve();
+	EEPROM.put(SETTINGS_ROM_ADDRESS, g_RomSettings);
+}
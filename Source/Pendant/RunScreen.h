@@ -1,4 +1,3 @@
-DEFINE_STRING(g_StrJOB, "JOB:");
 DEFINE_STRING(g_StrRPM_0, "RPM 0");
 DEFINE_STRING(g_StrRPM0, "RPM0");
 DEFINE_STRING(g_StrFEED, "FEED:");
@@ -34,146 +33,115 @@ RunScreen::ScreenState RunScreen::DecodeState( void ) const
 	return STATE_OTHER;
 }
 
-void RunScreen::Draw( void )
+const WidgetLayout RunScreen::s_Layout[WIDGET_COUNT] PROGMEM =
 {
-	ScreenState screenState = DecodeState();
-
-#if PARTIAL_SCREEN_UPDATE
-	DrawState *pDrawState = reinterpret_cast<DrawState*>(s_DrawState.custom);
-	const bool bDrawAll = s_DrawState.bDrawAll || pDrawState->bShowInches != g_bShowInches || pDrawState->screenState != screenState;
-	pDrawState->bShowInches = g_bShowInches;
-	pDrawState->screenState = screenState;
-	if (bDrawAll && !s_DrawState.bDrawAll)
-	{
-		ClearBuffer();
-	}
+	{WIDGET_STATUS, 0, 0},
+	{WIDGET_COORD, 2, 1},
+	{WIDGET_COORD, 2, 2},
+	{WIDGET_COORD, 2, 3},
+	{WIDGET_BUTTON, BUTTON_RUN, 0},
+	{WIDGET_BUTTON, BUTTON_STOP, 0},
+	{WIDGET_BUTTON, BUTTON_RPM0, 0},
+	{WIDGET_CUSTOM, 12, 4},
+	{WIDGET_CUSTOM, 0, 4},
+};
 
-	const bool bDrawX = bDrawAll || pDrawState->x != g_WorkX;
-	const bool bDrawY = bDrawAll || pDrawState->y != g_WorkY;
-	const bool bDrawZ = bDrawAll || pDrawState->z != g_WorkZ;
-	bool bDrawFS = bDrawAll || pDrawState->f != g_FeedOverride || pDrawState->_override != m_Override;
-	bDrawFS = bDrawFS || pDrawState->s != g_SpeedOverride || pDrawState->_override != m_Override;
-	bDrawFS = bDrawFS || (m_Override != 0 && (pDrawState->rf != g_RealFeed || pDrawState->rs != g_RealSpeed));
-	pDrawState->x = g_WorkX;
-	pDrawState->y = g_WorkY;
-	pDrawState->z = g_WorkZ;
-	pDrawState->f = g_FeedOverride;
-	pDrawState->s = g_SpeedOverride;
-	pDrawState->rf = g_RealFeed;
-	pDrawState->rs = g_RealSpeed;
-	pDrawState->_override = m_Override;
-#else
-	const bool bDrawX = true, bDrawY = true, bDrawZ = true, bDrawFS = true, bDrawAll = true;
-#endif
+void RunScreen::Draw( void )
+{
+	SetText(WIDGET_STATUS_LINE, ROMSTR("JOB"), 3);
+	SetCoord(WIDGET_X, g_StrX, ToDisplayUnits(g_WorkX), false);
+	SetCoord(WIDGET_Y, g_StrY, ToDisplayUnits(g_WorkY), false);
+	SetCoord(WIDGET_Z, g_StrZ, ToDisplayUnits(g_WorkZ), false);
 
-	if (bDrawAll)
+	SetUnused(WIDGET_RUN);
+	SetUnused(WIDGET_STOP);
+	SetUnused(WIDGET_RPM0);
+	switch (DecodeState())
 	{
-		DrawMachineStatus(ROMSTR("JOB"), 3);
-		uint8_t unusedButtons = 0x70;
-		switch (screenState)
-		{
-			case STATE_IDLE: // job hasn't started, ready to run
-				DrawButton(BUTTON_RUN, ROMSTR("Run"), 3, true);
-				DrawButton(BUTTON_BACK, g_StrBack, 4, false);
-				unusedButtons &= ~((1<<BUTTON_RUN)|(1<<BUTTON_BACK));
-				break;
+		case STATE_IDLE: // job hasn't started, ready to run
+			SetText(WIDGET_RUN, ROMSTR("Run"), 3, true);
+			SetText(WIDGET_STOP, g_StrBack, 4);
+			break;
 
-			case STATE_RUNNING: // job is currently running
-				DrawButton(BUTTON_PAUSE, ROMSTR("Pause"), 5, false);
-				DrawButton(BUTTON_STOP, g_StrSTOP, 4, false);
-				unusedButtons &= ~((1<<BUTTON_PAUSE)|(1<<BUTTON_STOP));
-				break;
+		case STATE_RUNNING: // job is currently running
+			SetText(WIDGET_RUN, ROMSTR("Pause"), 5);
+			SetText(WIDGET_STOP, g_StrSTOP, 4);
+			break;
 
-			case STATE_PAUSED: // job is paused, but not clear to resume
-				if (g_RealSpeed > 0)
-				{
-					DrawButton(BUTTON_RPM0, g_StrRPM_0, 5, false);
-					unusedButtons &= ~(1<<BUTTON_RPM0);
-				}
-				// fallthrough
-			case STATE_PAUSING: // stopping (still show STOP to avoid flicker)
-				DrawButton(BUTTON_STOP, g_StrSTOP, 4, false);
-				unusedButtons &= ~(1<<BUTTON_STOP);
-				break;
+		case STATE_PAUSED_READY: // job is ready to resome
+			SetText(WIDGET_RUN, ROMSTR("Resume"), 6, true);
+			// fallthrough
+		case STATE_PAUSED: // job is paused, but not clear to resume
+			if (g_RealSpeed > 0)
+			{
+				SetText(WIDGET_RPM0, g_StrRPM_0, 5);
+			}
+			// fallthrough
+		case STATE_PAUSING: // stopping (still show STOP to avoid flicker)
+			SetText(WIDGET_STOP, g_StrSTOP, 4);
+			break;
 
-			case STATE_PAUSED_READY: // job is ready to resome
-				DrawButton(BUTTON_RESUME, ROMSTR("Resume"), 6, true);
-				DrawButton(BUTTON_STOP, g_StrSTOP, 4, false);
-				unusedButtons &= ~((1<<BUTTON_RESUME)|(1<<BUTTON_STOP));
-				if (g_RealSpeed > 0)
-				{
-					DrawButton(BUTTON_RPM0, g_StrRPM_0, 5, false);
-					unusedButtons &= ~(1<<BUTTON_RPM0);
-				}
-				break;
-		}
-		DrawUnusedButtons(unusedButtons);
+		default:
+			break;
 	}
 
-	if (bDrawX)
-	{
-		DrawText(0, 1, g_StrX);
-		PrintCoord(g_TextBuf, g_WorkX); DrawText(2, 1, g_TextBuf);
-	}
+	// the real value is shown only for the selected override
+	SetValue(WIDGET_FEED, g_FeedOverride | ((m_Override == BUTTON_FEED ? (uint32_t)g_RealFeed : 0) << 16), m_Override == BUTTON_FEED);
+	SetValue(WIDGET_SPEED, g_SpeedOverride | ((m_Override == BUTTON_SPEED ? (uint32_t)g_RealSpeed : 0) << 16), m_Override == BUTTON_SPEED);
+
+	DrawWidgets(s_Layout, WIDGET_COUNT);
+}
 
-	if (bDrawY)
+void RunScreen::DrawCustomWidget( uint8_t index, const WidgetLayout &layout, bool bChanged )
+{
+	// the feed and speed overlap when showing the real values, so the whole row is drawn by WIDGET_FEED
+	if (index == WIDGET_SPEED)
 	{
-		PrintCoord(g_TextBuf, g_WorkY); DrawText(2, 2, g_TextBuf);
-		DrawText(0, 2, g_StrY);
+		s_Widgets[WIDGET_FEED].flags |= WIDGET_DIRTY;
+		return;
 	}
 
-	if (bDrawZ)
+	if (bChanged)
 	{
-		PrintCoord(g_TextBuf, g_WorkZ); DrawText(2, 3, g_TextBuf);
-		DrawText(0, 3, g_StrZ);
+		SetDrawColor(0);
+		DrawBox(0, g_Rows[4] - 1, 128, 10);
+		SetDrawColor(1);
 	}
-
-	if (bDrawFS)
+	Sprintf(g_TextBuf, "F %3d%%", g_FeedOverride);
+	if (m_Override == BUTTON_FEED)
 	{
-#if PARTIAL_SCREEN_UPDATE
-		if (!bDrawAll)
+		DrawTextBold(0, 4, g_TextBuf);
+		if (g_RealFeed != 0)
 		{
+			int8_t len = Sprintf(g_TextBuf, "%dmm/min", g_RealFeed);
+			DrawBox(49, g_Rows[4] - 1, len * 7 + 2, 10);
 			SetDrawColor(0);
-			DrawBox(0, g_Rows[4] - 1, 128, 10);
+			DrawText(7, 4, g_TextBuf);
 			SetDrawColor(1);
 		}
-#endif
-		Sprintf(g_TextBuf, "F %3d%%", g_FeedOverride);
-		if (m_Override == BUTTON_FEED)
-		{
-			DrawTextBold(0, 4, g_TextBuf);
-			if (g_RealFeed != 0)
-			{
-				int8_t len = Sprintf(g_TextBuf, "%dmm/min", g_RealFeed);
-				DrawBox(49, g_Rows[4] - 1, len * 7 + 2, 10);
-				SetDrawColor(0);
-				DrawText(7, 4, g_TextBuf);
-				SetDrawColor(1);
-			}
-		}
-		else if (m_Override != BUTTON_SPEED || g_RealSpeed == 0)
-		{
-			DrawText(0, 4, g_TextBuf);
-		}
+	}
+	else if (m_Override != BUTTON_SPEED || g_RealSpeed == 0)
+	{
+		DrawText(0, 4, g_TextBuf);
+	}
 
-		Sprintf(g_TextBuf, "S %3d%%", g_SpeedOverride);
-		if (m_Override == BUTTON_SPEED)
-		{
-			DrawTextBold(12, 4, g_TextBuf);
-			if (g_RealSpeed != 0)
-			{
-				int8_t len = Sprintf(g_TextBuf, "%drpm", g_RealSpeed);
-				DrawBox(77 - len * 7, g_Rows[4] - 1, len * 7 + 2, 10);
-				SetDrawColor(0);
-				DrawText(11 - len, 4, g_TextBuf);
-				SetDrawColor(1);
-			}
-		}
-		else if (m_Override != BUTTON_FEED || g_RealFeed == 0)
+	Sprintf(g_TextBuf, "S %3d%%", g_SpeedOverride);
+	if (m_Override == BUTTON_SPEED)
+	{
+		DrawTextBold(12, 4, g_TextBuf);
+		if (g_RealSpeed != 0)
 		{
-			DrawText(12, 4, g_TextBuf);
+			int8_t len = Sprintf(g_TextBuf, "%drpm", g_RealSpeed);
+			DrawBox(77 - len * 7, g_Rows[4] - 1, len * 7 + 2, 10);
+			SetDrawColor(0);
+			DrawText(11 - len, 4, g_TextBuf);
+			SetDrawColor(1);
 		}
 	}
+	else if (m_Override != BUTTON_FEED || g_RealFeed == 0)
+	{
+		DrawText(12, 4, g_TextBuf);
+	}
 }
 
 void RunScreen::Update( unsigned long time )
@@ -189,15 +157,15 @@ void RunScreen::Update( unsigned long time )
 			m_OverrideTimer = time;
 			if (m_Override == BUTTON_SPEED)
 			{
-				Serial.print(g_StrSPEED);
-				Serial.println(wheel);
+				g_Port.print(g_StrSPEED);
+				g_Port.println(wheel);
 				return;
 			}
 
 			if (m_Override == BUTTON_FEED)
 			{
-				Serial.print(g_StrFEED);
-				Serial.println(wheel);
+				g_Port.print(g_StrFEED);
+				g_Port.println(wheel);
 				return;
 			}
 		}
@@ -210,8 +178,8 @@ void RunScreen::Update( unsigned long time )
 
 		if (TestBit(g_ButtonHold, m_Override))
 		{
-			Serial.print(m_Override == BUTTON_SPEED ? g_StrSPEED : g_StrFEED);
-			Serial.println(0);
+			g_Port.print(m_Override == BUTTON_SPEED ? g_StrSPEED : g_StrFEED);
+			g_Port.println(0);
 			return;
 		}
 	}
@@ -232,14 +200,12 @@ void RunScreen::Update( unsigned long time )
 			{
 				if (button == BUTTON_PAUSE)
 				{
-					Serial.print(g_StrJOB);
-					Serial.println(ROMSTR("PAUSE"));
+					g_Port.SendRealtime(REALTIME_FEED_HOLD);
 					return;
 				}
 				if (button == BUTTON_STOP)
 				{
-					Serial.print(g_StrJOB);
-					Serial.println(g_StrSTOP);
+					g_Port.SendRealtime(REALTIME_JOB_STOP);
 					return;
 				}
 				if (m_JobState == JOB_STARTED)
@@ -252,14 +218,13 @@ void RunScreen::Update( unsigned long time )
 			{
 				if (button == BUTTON_STOP)
 				{
-					Serial.print(g_StrJOB);
-					Serial.println(g_StrSTOP);
+					g_Port.SendRealtime(REALTIME_JOB_STOP);
 					return;
 				}
 				if (button == BUTTON_RPM0)
 				{
-					Serial.print(g_StrJOB);
-					Serial.println(g_StrRPM0);
+					g_Port.print(g_StrJOB);
+					g_Port.println(g_StrRPM0);
 					return;
 				}
 			}
@@ -268,21 +233,20 @@ void RunScreen::Update( unsigned long time )
 			{
 				if (TestBit(g_ButtonHold, BUTTON_RESUME))
 				{
-					Serial.print(g_StrJOB);
-					Serial.println(ROMSTR("RESUME"));
+					g_Port.print(g_StrJOB);
+					g_Port.println(ROMSTR("RESUME"));
 					return;
 				}
 				if (button == BUTTON_STOP)
 				{
-					Serial.print(g_StrJOB);
-					Serial.println(g_StrSTOP);
+					g_Port.SendRealtime(REALTIME_JOB_STOP);
 					m_JobState = JOB_STOPPED;
 					return;
 				}
 				if (button == BUTTON_RPM0)
 				{
-					Serial.print(g_StrJOB);
-					Serial.println(g_StrRPM0);
+					g_Port.print(g_StrJOB);
+					g_Port.println(g_StrRPM0);
 					return;
 				}
 			}
@@ -298,8 +262,8 @@ void RunScreen::Update( unsigned long time )
 				{
 					if (TestBit(g_ButtonHold, BUTTON_RUN))
 					{
-						Serial.print(g_StrJOB);
-						Serial.println(g_StrSTART);
+						g_Port.print(g_StrJOB);
+						g_Port.println(g_StrSTART);
 						m_JobState = JOB_STARTED;
 						return;
 					}
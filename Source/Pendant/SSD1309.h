@@ -0,0 +1,193 @@
+#pragma once
+
+// Built-in driver for the SSD1309 128x64 display over I2C. It implements only the few u8g2 functions used by the
+// pendant, so Graphics.h works with either one. The buffer has the u8g2 layout - 128 bytes per 8-pixel page, one byte
+// per column. The data is written with the largest transmissions Wire can buffer, and the addressing commands are sent
+// in the same transmission as the first data bytes
+
+#define U8X8_PROGMEM PROGMEM
+
+const uint8_t SSD1309_ADDRESS = 0x3C;
+
+#if U8G2_FULL_BUFFER
+const uint8_t SSD1309_BUFFER_PAGES = 8;
+#else
+const uint8_t SSD1309_BUFFER_PAGES = 2; // the screen is drawn in strips of 16 pixels, like with the u8g2 _2 buffer
+#endif
+
+// The most bytes to send after the control byte in one transmission
+#if defined(BUFFER_LENGTH)
+const uint8_t SSD1309_BURST = BUFFER_LENGTH > 128 ? 128 : BUFFER_LENGTH - 1;
+#elif defined(I2C_BUFFER_LENGTH)
+const uint8_t SSD1309_BURST = I2C_BUFFER_LENGTH > 128 ? 128 : I2C_BUFFER_LENGTH - 1;
+#else
+const uint8_t SSD1309_BURST = 31;
+#endif
+
+#if defined(ARDUINO_NANO_R4)
+TwoWire &g_DisplayWire = Wire1; // on Nano R4 use the second Wire interface for the Qwiic connector (ignore this if using regular I2C)
+#else
+TwoWire &g_DisplayWire = Wire;
+#endif
+
+const uint8_t g_DisplayInit[] PROGMEM =
+{
+	0xFD, 0x12, // unlock
+	0xAE, // display off
+	0xD5, 0xA0, // clock divide ratio and oscillator frequency
+	0xA8, 0x3F, // multiplex ratio
+	0xD3, 0x00, // display offset
+	0x40, // start line 0
+	0xA1, // segment remap
+	0xC8, // reverse COM scan direction
+	0xDA, 0x12, // COM pins configuration
+	0x81, 0x6F, // contrast
+	0xD9, 0x82, // pre-charge period
+	0xDB, 0x34, // VCOMH deselect level
+	0x20, 0x02, // page addressing mode
+	0x2E, // deactivate scroll
+	0xA4, // show the RAM contents
+	0xA6, // not inverted
+};
+
+struct u8g2_t
+{
+	uint8_t buffer[SSD1309_BUFFER_PAGES * 128];
+	uint8_t drawColor;
+	uint8_t tileRow; // the first page in the buffer
+};
+
+void SSD1309_SendCommands( const uint8_t *commands, uint8_t count )
+{
+	g_DisplayWire.beginTransmission(SSD1309_ADDRESS);
+	g_DisplayWire.write(0x00); // command stream
+	for (uint8_t i = 0; i < count; i++)
+	{
+		g_DisplayWire.write(pgm_read_byte(commands + i));
+	}
+	g_DisplayWire.endTransmission();
+}
+
+// Sends count bytes to the given page of the display, starting at column x
+void SSD1309_SendData( uint8_t page, uint8_t x, const uint8_t *data, uint8_t count )
+{
+	// each addressing command has its own control byte (0x80), followed by the data stream (0x40)
+	const uint8_t address[6] = {0x80, (uint8_t)(0xB0 | page), 0x80, (uint8_t)(x & 0x0F), 0x80, (uint8_t)(0x10 | (x >> 4))};
+	g_DisplayWire.beginTransmission(SSD1309_ADDRESS);
+	g_DisplayWire.write(address, sizeof(address));
+	uint8_t room = SSD1309_BURST - sizeof(address);
+	for (;;)
+	{
+		uint8_t len = count < room ? count : room;
+		g_DisplayWire.write(0x40);
+		g_DisplayWire.write(data, len);
+		g_DisplayWire.endTransmission();
+		data += len;
+		count -= len;
+		if (count == 0)
+		{
+			break;
+		}
+		g_DisplayWire.beginTransmission(SSD1309_ADDRESS);
+		room = SSD1309_BURST;
+	}
+}
+
+void u8g2_InitDisplay( u8g2_t *u8g2 )
+{
+	g_DisplayWire.begin();
+	g_DisplayWire.setClock(400000);
+	SSD1309_SendCommands(g_DisplayInit, sizeof(g_DisplayInit));
+	u8g2->drawColor = 1;
+	u8g2->tileRow = 0;
+}
+
+void u8g2_SetPowerSave( u8g2_t *u8g2, uint8_t bPowerSave )
+{
+	static const uint8_t s_DisplayOn[] PROGMEM = {0xAF};
+	static const uint8_t s_DisplayOff[] PROGMEM = {0xAE};
+	SSD1309_SendCommands(bPowerSave ? s_DisplayOff : s_DisplayOn, 1);
+}
+
+inline uint8_t *u8g2_GetBufferPtr( u8g2_t *u8g2 ) { return u8g2->buffer; }
+inline uint8_t u8g2_GetBufferTileHeight( u8g2_t *u8g2 ) { return SSD1309_BUFFER_PAGES; }
+inline uint8_t u8g2_GetBufferCurrTileRow( u8g2_t *u8g2 ) { return u8g2->tileRow; }
+inline void u8g2_SetDrawColor( u8g2_t *u8g2, uint8_t color ) { u8g2->drawColor = color; }
+
+void u8g2_ClearBuffer( u8g2_t *u8g2 )
+{
+	memset(u8g2->buffer, 0, sizeof(u8g2->buffer));
+}
+
+void u8g2_ClearDisplay( u8g2_t *u8g2 )
+{
+	u8g2_ClearBuffer(u8g2);
+	for (uint8_t page = 0; page < 8; page++)
+	{
+		SSD1309_SendData(page, 0, u8g2->buffer, 128);
+	}
+}
+
+// Fills the box with the draw color, clipped to the pages in the buffer
+void u8g2_DrawBox( u8g2_t *u8g2, uint8_t x, uint8_t y, uint8_t w, uint8_t h )
+{
+	if (x >= 128) return;
+	if (w > 128 - x) w = 128 - x;
+	const int16_t y2 = y + h;
+	for (uint8_t i = 0; i < SSD1309_BUFFER_PAGES; i++)
+	{
+		const int16_t top = (u8g2->tileRow + i) * 8;
+		if (y >= top + 8 || y2 <= top) continue;
+		uint8_t mask = 0xFF;
+		if (y > top) mask <<= y - top;
+		if (y2 < top + 8) mask &= 0xFF >> (top + 8 - y2);
+		uint8_t *dst = u8g2->buffer + i * 128 + x;
+		if (u8g2->drawColor)
+		{
+			for (uint8_t j = 0; j < w; j++) dst[j] |= mask;
+		}
+		else
+		{
+			mask = ~mask;
+			for (uint8_t j = 0; j < w; j++) dst[j] &= mask;
+		}
+	}
+}
+
+#if U8G2_FULL_BUFFER
+void u8g2_UpdateDisplayArea( u8g2_t *u8g2, uint8_t tx, uint8_t ty, uint8_t tw, uint8_t th )
+{
+	for (uint8_t page = ty; page < ty + th; page++)
+	{
+		SSD1309_SendData(page, tx * 8, u8g2->buffer + page * 128 + tx * 8, tw * 8);
+	}
+}
+
+void u8g2_SendBuffer( u8g2_t *u8g2 )
+{
+	u8g2_UpdateDisplayArea(u8g2, 0, 0, 16, 8);
+}
+#else
+void u8g2_FirstPage( u8g2_t *u8g2 )
+{
+	u8g2->tileRow = 0;
+	u8g2_ClearBuffer(u8g2);
+}
+
+// Sends the current strip and moves to the next one. Returns 0 after the last strip
+uint8_t u8g2_NextPage( u8g2_t *u8g2 )
+{
+	for (uint8_t i = 0; i < SSD1309_BUFFER_PAGES; i++)
+	{
+		SSD1309_SendData(u8g2->tileRow + i, 0, u8g2->buffer + i * 128, 128);
+	}
+	u8g2->tileRow += SSD1309_BUFFER_PAGES;
+	if (u8g2->tileRow >= 8)
+	{
+		u8g2->tileRow = 0;
+		return 0;
+	}
+	u8g2_ClearBuffer(u8g2);
+	return 1;
+}
+#endif
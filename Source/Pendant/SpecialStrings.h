@@ -70,6 +70,7 @@ DEFINE_STRING(g_StrSTART, "START");
 DEFINE_STRING(g_StrCANCEL, "CANCEL");
 DEFINE_STRING(g_StrJOG, "JOG");
 DEFINE_STRING(g_StrJOG2, "JOG:");
+DEFINE_STRING(g_StrJOB, "JOB:");
 DEFINE_STRING(g_StrPROBE, "PROBE");
 DEFINE_STRING(g_StrPROBE2, "PROBE:");
 DEFINE_STRING(g_StrComma, ",");
@@ -18,7 +18,7 @@ void ZProbeScreen::Draw( void )
 
 #if PARTIAL_SCREEN_UPDATE
 	DrawState *pDrawState = reinterpret_cast<DrawState*>(s_DrawState.custom);
-	const bool bDrawAll = s_DrawState.bDrawAll || pDrawState->unusedButtons == unusedButtons;
+	const bool bDrawAll = s_DrawState.bDrawAll || pDrawState->unusedButtons != unusedButtons;
 	const bool bDrawUp = bDrawAll || pDrawState->bJoggingUp != m_bJoggingUp;
 	const bool bDrawDown = bDrawAll || pDrawState->bJoggingDown != m_bJoggingDown;
 	const bool bDrawContact = bDrawAll || pDrawState->bContact != g_bProbeContact;
@@ -28,13 +28,13 @@ void ZProbeScreen::Draw( void )
 	pDrawState->bContact = g_bProbeContact;
 	if (bDrawAll && !s_DrawState.bDrawAll)
 	{
-		ClearBuffer();
+		RedrawAll();
 	}
 #else
 	const bool bDrawButton = true, bDrawUp = true, bDrawDown = true, bDrawContact = true, bDrawAll = true;
 #endif
 
-	if (bDrawAll)
+	if (bDrawAll || HasDirtyRegions())
 	{
 		DrawMachineStatus(g_StrPROBE, 5);
 		DrawButton(BUTTON_BACK, g_StrBack, 4, false);
@@ -147,21 +147,21 @@ void ZProbeScreen::Update( unsigned long time )
 	{
 		if (TestBit(g_ButtonState, BUTTON_UP))
 		{
-			Serial.print(g_StrPROBE2);
-			Serial.println(ROMSTR("Z+"));
+			g_Port.print(g_StrPROBE2);
+			g_Port.println(ROMSTR("Z+"));
 			m_bJoggingUp = true;
 		}
 		else if (TestBit(g_ButtonState, BUTTON_DOWN))
 		{
-			Serial.print(g_StrPROBE2);
-			Serial.println(ROMSTR("Z-"));
+			g_Port.print(g_StrPROBE2);
+			g_Port.println(ROMSTR("Z-"));
 			m_bJoggingDown = true;
 		}
 	}
 	if ((m_bJoggingUp && !TestBit(g_ButtonState, BUTTON_UP)) || (m_bJoggingDown && !TestBit(g_ButtonState, BUTTON_DOWN)))
 	{
-		Serial.print(g_StrPROBE2);
-		Serial.println(ROMSTR("Z="));
+		g_Port.print(g_StrPROBE2);
+		g_Port.println(ROMSTR("Z="));
 		m_bJoggingUp = m_bJoggingDown = false;
 	}
 
@@ -174,20 +174,20 @@ void ZProbeScreen::Update( unsigned long time )
 	{
 		if (m_ProbeMode == PROBE_Z)
 		{
-			Serial.print(g_StrPROBE2);
-			Serial.println(ROMSTR("CONNECT"));
+			g_Port.print(g_StrPROBE2);
+			g_Port.println(ROMSTR("CONNECT"));
 			m_bConfirmed = true;
 		}
 		else
 		{
-			Serial.print(g_StrPROBE2);
-			Serial.println(ROMSTR("GOTOSENSOR"));
+			g_Port.print(g_StrPROBE2);
+			g_Port.println(ROMSTR("GOTOSENSOR"));
 		}
 	}
 	else if (button == BUTTON_BACK)
 	{
-		Serial.print(g_StrPROBE2);
-		Serial.println(g_StrCANCEL);
+		g_Port.print(g_StrPROBE2);
+		g_Port.println(g_StrCANCEL);
 		if (g_ProbeState & PROBE_TLO_ENABLED)
 		{
 			g_ProbeMenuScreen.Activate(time);
@@ -199,21 +199,21 @@ void ZProbeScreen::Update( unsigned long time )
 	}
 	else if (m_bConfirmed && g_MachineStatus == STATUS_IDLE && m_ProbeMode == PROBE_Z && (g_ProbeState & PROBE_MEASURE_ENABLED) && TestBit(g_ButtonHold, BUTTON_MEASURE))
 	{
-		Serial.print(g_StrPROBE2);
-		Serial.print(g_StrSTART);
-		Serial.println(PROBE_MEASURE_Z);
+		g_Port.print(g_StrPROBE2);
+		g_Port.print(g_StrSTART);
+		g_Port.println(PROBE_MEASURE_Z);
 		CloseScreen();
 	}
 	else if (m_bConfirmed && g_MachineStatus == STATUS_IDLE && TestBit(g_ButtonHold, BUTTON_PROBE))
 	{
-		Serial.print(g_StrPROBE2);
-		Serial.print(g_StrSTART);
-		Serial.println(m_ProbeMode);
+		g_Port.print(g_StrPROBE2);
+		g_Port.print(g_StrSTART);
+		g_Port.println(m_ProbeMode);
 		CloseScreen();
 	}
 	else if (g_bCanShowStop && button == BUTTON_STOP)
 	{
-		Serial.println(g_StrSTOP);
+		g_Port.SendRealtime(REALTIME_STOP);
 	}
 }
 
@@ -223,9 +223,9 @@ void ZProbeScreen::Activate( unsigned long time, ProbeMode mode, bool bNotify )
 	m_ProbeMode = mode;
 	if (bNotify)
 	{
-		Serial.print(g_StrPROBE2);
-		Serial.print(g_StrENTER);
-		Serial.println(m_ProbeMode);
+		g_Port.print(g_StrPROBE2);
+		g_Port.print(g_StrENTER);
+		g_Port.println(m_ProbeMode);
 	}
 	m_bConfirmed = false;
 	m_bJoggingUp = false;
@@ -238,8 +238,8 @@ void ZProbeScreen::Deactivate( void )
 {
 	if (m_bJoggingUp || m_bJoggingDown)
 	{
-		Serial.print(g_StrPROBE2);
-		Serial.println(ROMSTR("Z="));
+		g_Port.print(g_StrPROBE2);
+		g_Port.println(ROMSTR("Z="));
 		m_bJoggingUp = false;
 		m_bJoggingDown = false;
 	}
@@ -34,13 +34,24 @@ public:
 protected:
 	static int8_t GetCurrentButton( void );
 
-	// Prints a value to the buffer, using the curren mm/inch setting
-	static void PrintCoord( char *buf, float val );
+	// Converts micrometers to the display units - 0.001 inch or 0.01 mm, depending on the current mm/inch setting
+	static int32_t ToDisplayUnits( int32_t val );
+
+	// Prints a value in display units to the buffer, using the curren mm/inch setting
+	static void PrintDisplayUnits( char *buf, int32_t val );
+
+	// Prints a value in micrometers to the buffer, using the curren mm/inch setting
+	static void PrintCoord( char *buf, int32_t val ) { PrintDisplayUnits(buf, ToDisplayUnits(val)); }
+
+	// Returns X/Y/Z in display units. Uses the current WCS/MCS and mm/inch settings
+	static int32_t GetDisplayX( void ) { return ToDisplayUnits(g_bWorkSpace ? g_WorkX : (g_WorkX + g_OffsetX)); }
+	static int32_t GetDisplayY( void ) { return ToDisplayUnits(g_bWorkSpace ? g_WorkY : (g_WorkY + g_OffsetY)); }
+	static int32_t GetDisplayZ( void ) { return ToDisplayUnits(g_bWorkSpace ? g_WorkZ : (g_WorkZ + g_OffsetZ)); }
 
 	// Print X/Y/Z to the buffer. Uses the current WCS/MCS and mm/inch settings
-	static void PrintX( char *buf );
-	static void PrintY( char *buf );
-	static void PrintZ( char *buf );
+	static void PrintX( char *buf ) { PrintDisplayUnits(buf, GetDisplayX()); }
+	static void PrintY( char *buf ) { PrintDisplayUnits(buf, GetDisplayY()); }
+	static void PrintZ( char *buf ) { PrintDisplayUnits(buf, GetDisplayZ()); }
 
 	// Draws the status line at the top of the screen
 #if DRAW_SCREEN_TITLE
@@ -54,6 +65,9 @@ protected:
 	static void DrawMachineStatusInt( void );
 #endif
 
+	// Returns true if the button's label is in the current strip (see IsAreaVisible)
+	static bool IsButtonVisible( uint8_t button ) { return IsRowVisible(button < 4 ? button + 1 : button - 3); }
+
 	// Draws a blank button symbol for unused buttons according to the mask
 	static void DrawUnusedButtons( uint16_t mask );
 
@@ -66,6 +80,30 @@ protected:
 	// Closes the screen if it is active and switches to the default main screen
 	void CloseScreen( void );
 
+	// The regions that depend on the global state - one per button label and the status line. When only the buttons or
+	// the machine status change, just these regions are cleared and redrawn. DrawButton, DrawUnusedButtons and
+	// DrawMachineStatus skip the regions that are not dirty
+	static const uint8_t STATUS_REGION = 8;
+	static const uint8_t REGION_COUNT = 9;
+
+#if PARTIAL_SCREEN_UPDATE
+	// Returns true if any of the regions in the mask needs to be drawn
+	static bool IsRegionDirty( uint16_t mask ) { return s_DrawState.bDrawAll || (s_DrawState.dirtyRegions & mask) != 0; }
+
+	// Returns true if some regions were cleared for redrawing. The screens draw their buttons and the status line
+	// when this or bDrawAll is set
+	static bool HasDirtyRegions( void ) { return s_DrawState.dirtyRegions != 0; }
+
+	// Clears the buffer to redraw everything, after the screen's own state changed
+	static void RedrawAll( void );
+
+	// Clears the regions in the mask and marks them dirty
+	static void ClearRegions( uint16_t regions );
+#else
+	static bool IsRegionDirty( uint16_t mask ) { return true; }
+	static bool HasDirtyRegions( void ) { return false; }
+#endif
+
 #if PARTIAL_SCREEN_UPDATE
 	struct DrawStateBase
 	{
@@ -75,6 +113,8 @@ protected:
 		MachineStatus machineStatus;
 		int8_t jobProgress;
 		bool bDrawAll;
+		uint16_t dirtyRegions; // bit per region cleared for redrawing this frame
+		uint8_t regionWidths[REGION_COUNT]; // the drawn width of each region, 0xFF if it's not on the screen
 
 		uint8_t custom[32]; // for use by the current screen, initialized to 0xFF
 	};
@@ -87,13 +127,30 @@ protected:
 
 	static DrawStateBase s_DrawState;
 
-private:
 	static void DrawButtonInt( uint8_t button, const char *label, uint8_t labelLen, bool bHold, bool bRomStr );
+
+private:
+#if !U8G2_FULL_BUFFER
+	// In page mode Draw runs once per strip, and the Y and Z rows are on two strips each. The last formatted values are
+	// kept, so each coordinate is formatted once per frame
+	struct FormattedValue
+	{
+		int32_t val;
+		uint8_t decimals;
+		char text[13];
+	};
+	static FormattedValue s_FormattedValues[2];
+	static uint8_t s_NextFormattedValue;
+#endif
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 
 BaseScreen::DrawStateBase BaseScreen::s_DrawState;
+#if !U8G2_FULL_BUFFER
+BaseScreen::FormattedValue BaseScreen::s_FormattedValues[2];
+uint8_t BaseScreen::s_NextFormattedValue;
+#endif
 
 void BaseScreen::Activate( unsigned long time )
 {
@@ -104,13 +161,12 @@ void BaseScreen::Activate( unsigned long time )
 	if (s_pCurrentScreen != this)
 	{
 		ReleaseAllButtons();
+		StateChanged();
 
 #if PARTIAL_SCREEN_UPDATE
 		// clear draw state on screen change
 		memset(&s_DrawState, 0xFF, sizeof(s_DrawState));
-		g_DirtyRect[0] = g_DirtyRect[1] = 0;
-		g_DirtyRect[2] = 128;
-		g_DirtyRect[3] = 64;
+		InvalidateRect();
 #endif
 	}
 	s_pCurrentScreen = this;
@@ -119,16 +175,25 @@ void BaseScreen::Activate( unsigned long time )
 #if U8G2_FULL_BUFFER
 void BaseScreen::ClearScreen( void )
 {
+#if SHADOW_SCREEN_BUFFER
+	s_DrawState.bDrawAll = true; // always draw everything. UpdateScreen finds the changes
+#endif
 #if PARTIAL_SCREEN_UPDATE
-	s_DrawState.bDrawAll |= s_DrawState.buttonState != g_ButtonState ||
-		s_DrawState.buttonHold != g_ButtonHold ||
-		s_DrawState.buttonDown != g_ButtonDown ||
-		s_DrawState.machineStatus != g_MachineStatus ||
-		s_DrawState.jobProgress != g_JobProgress;
 	if (!s_DrawState.bDrawAll)
 	{
+		// the button bits affect only the labels of their buttons, and the status and progress only the status line
+		uint16_t regions = (s_DrawState.buttonState ^ g_ButtonState) | (s_DrawState.buttonHold ^ g_ButtonHold) |
+			(s_DrawState.buttonDown ^ g_ButtonDown);
+		regions &= (1 << STATUS_REGION) - 1;
+		if (s_DrawState.machineStatus != g_MachineStatus || s_DrawState.jobProgress != g_JobProgress)
+		{
+			regions |= 1 << STATUS_REGION;
+		}
+		s_DrawState.dirtyRegions = 0;
+		ClearRegions(regions);
 		return;
 	}
+	memset(s_DrawState.regionWidths, 0xFF, sizeof(s_DrawState.regionWidths));
 #endif
 	ClearBuffer();
 }
@@ -136,13 +201,46 @@ void BaseScreen::ClearScreen( void )
 #if PARTIAL_SCREEN_UPDATE
 void BaseScreen::UpdateScreen( void )
 {
-	UpdateDirtyRect();
+#if SHADOW_SCREEN_BUFFER
+	DiffShadowBuffer();
+#endif
+	BeginFlush();
 	s_DrawState.buttonState = g_ButtonState;
 	s_DrawState.buttonHold = g_ButtonHold;
 	s_DrawState.buttonDown = g_ButtonDown;
 	s_DrawState.machineStatus = g_MachineStatus;
 	s_DrawState.jobProgress = g_JobProgress;
 	s_DrawState.bDrawAll = false;
+	s_DrawState.dirtyRegions = 0;
+}
+
+void BaseScreen::ClearRegions( uint16_t regions )
+{
+	s_DrawState.dirtyRegions |= regions;
+	SetDrawColor(0);
+	for (uint8_t i = 0; regions; i++, regions >>= 1)
+	{
+		const uint8_t w = s_DrawState.regionWidths[i];
+		if ((regions & 1) && w != 0xFF)
+		{
+			if (i == STATUS_REGION)
+			{
+				DrawBox(0, 0, 128, 11);
+			}
+			else
+			{
+				DrawBox(i < 4 ? 0 : 128 - w, g_Rows[i < 4 ? i + 1 : i - 3] - 1, w, 10);
+			}
+		}
+	}
+	SetDrawColor(1);
+}
+
+void BaseScreen::RedrawAll( void )
+{
+	ClearBuffer();
+	memset(s_DrawState.regionWidths, 0xFF, sizeof(s_DrawState.regionWidths));
+	s_DrawState.bDrawAll = true;
 }
 #endif
 #endif
@@ -162,31 +260,63 @@ int8_t BaseScreen::GetCurrentButton( void )
 	return -1;
 }
 
-void BaseScreen::PrintCoord( char *buf, float val )
-{
-	if (g_bShowInches)
-	{
-		dtostrf(val / 25.4f, 8, 3, buf);
-	}
-	else
-	{
-		dtostrf(val, 8, 2, buf);
-	}
-}
-
-void BaseScreen::PrintX( char *buf )
+int32_t BaseScreen::ToDisplayUnits( int32_t val )
 {
-	PrintCoord(buf, g_bWorkSpace ? g_WorkX : (g_WorkX + g_OffsetX));
+	// 1 inch = 25400um, so 0.001 inch = 25.4um
+	const int32_t num = g_bShowInches ? 10 : 1;
+	const int32_t den = g_bShowInches ? 254 : 10;
+	return val >= 0 ? (val * num + den / 2) / den : -((-val * num + den / 2) / den);
 }
 
-void BaseScreen::PrintY( char *buf )
+void BaseScreen::PrintDisplayUnits( char *buf, int32_t val )
 {
-	PrintCoord(buf, g_bWorkSpace ? g_WorkY : (g_WorkY + g_OffsetY));
-}
+	// same as dtostrf(val, 8, decimals, buf)
+	const uint8_t decimals = g_bShowInches ? 3 : 2;
+#if !U8G2_FULL_BUFFER
+	for (uint8_t i = 0; i < 2; i++)
+	{
+		if (s_FormattedValues[i].val == val && s_FormattedValues[i].decimals == decimals)
+		{
+			Strcpy(buf, s_FormattedValues[i].text);
+			return;
+		}
+	}
+	FormattedValue &formatted = s_FormattedValues[s_NextFormattedValue];
+	s_NextFormattedValue ^= 1;
+	formatted.val = val;
+	formatted.decimals = decimals;
+	char *const start = buf;
+#endif
+	char digits[12];
+	uint8_t len = 0;
+	uint32_t absVal = val < 0 ? -val : val;
+	do
+	{
+		digits[len++] = '0' + absVal % 10;
+		absVal /= 10;
+	} while (absVal || len <= decimals);
 
-void BaseScreen::PrintZ( char *buf )
-{
-	PrintCoord(buf, g_bWorkSpace ? g_WorkZ : (g_WorkZ + g_OffsetZ));
+	uint8_t size = len + 1 + (val < 0 ? 1 : 0);
+	for (; size < 8; size++)
+	{
+		*buf++ = ' ';
+	}
+	if (val < 0)
+	{
+		*buf++ = '-';
+	}
+	while (len > 0)
+	{
+		if (len == decimals)
+		{
+			*buf++ = '.';
+		}
+		*buf++ = digits[--len];
+	}
+	*buf = 0;
+#if !U8G2_FULL_BUFFER
+	Strcpy(formatted.text, start);
+#endif
 }
 
 #if DRAW_SCREEN_TITLE
@@ -204,6 +334,13 @@ void BaseScreen::DrawMachineStatusInt( void )
 	const char *title = nullptr;
 	const uint8_t titleLen = 0;
 #endif
+	if (!IsAreaVisible(0, 11) || !IsRegionDirty(1 << STATUS_REGION))
+	{
+		return;
+	}
+#if PARTIAL_SCREEN_UPDATE
+	s_DrawState.regionWidths[STATUS_REGION] = 128;
+#endif
 
 #if DRAW_SCREEN_TITLE
 	if (titleLen > 0)
@@ -230,8 +367,9 @@ void BaseScreen::DrawMachineStatusInt( void )
 		DrawTextXY(x + 7, 0, GetStatusName(g_MachineStatus));
 		if (g_MachineStatus == STATUS_RUN && g_bJobRunning && g_JobProgress != -1)
 		{
-			Sprintf(g_TextBuf, " %3d%%", g_JobProgress);
-			DrawTextXY(x + 28, 0, g_TextBuf);
+			char progress[8]; // not g_TextBuf, which may hold a widget text
+			Sprintf(progress, " %3d%%", g_JobProgress);
+			DrawTextXY(x + 28, 0, progress);
 		}
 		DrawTextXY(x + len * 7 + 7, 0, ROMSTR("]"));
 		DrawBox(0, 10, 128, 1);
@@ -243,8 +381,11 @@ void BaseScreen::DrawUnusedButtons( uint16_t mask )
 	SetDrawColor(1);
 	for (uint16_t i = 0; i < 8; i++)
 	{
-		if (TestBit(mask, i))
+		if (TestBit(mask, i) && IsRegionDirty(1 << i))
 		{
+#if PARTIAL_SCREEN_UPDATE
+			s_DrawState.regionWidths[i] = 8;
+#endif
 			if (i < 4)
 			{
 				DrawText(0, i + 1, g_StrPlaceholder);
@@ -261,6 +402,13 @@ void BaseScreen::DrawButtonInt( uint8_t button, const char *label, uint8_t label
 {
 	Assert(Strlen(label) == labelLen);
 	SetDrawColor(1);
+	if (!IsButtonVisible(button) || !IsRegionDirty(1 << button))
+	{
+		return;
+	}
+#if PARTIAL_SCREEN_UPDATE
+	s_DrawState.regionWidths[button] = labelLen*7 + (bHold ? 9 : 1);
+#endif
 	if (button < 4)
 	{
 		// left side
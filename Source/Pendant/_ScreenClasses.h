@@ -96,7 +96,7 @@ public:
 	virtual void Deactivate( void ) override;
 
 // Parses the dialog description: <dialog id>|<title>|<line1>|<line2>|<line3>|<left button>,<right button>
-	void ParseDialog( const char *str );
+	void ParseDialog( char **fields );
 
 	// Sends a response to the PC
 	// DIALOG:<dialog id>|<value>
@@ -149,7 +149,7 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 // This screen allows for jogging the X/Y/Z axis with the wheel and the joystick
-class JogScreen : public BaseScreen
+class JogScreen : public WidgetScreen
 {
 public:
 	JogScreen( void );
@@ -161,7 +161,10 @@ public:
 	void SetAxis( uint8_t axis );
 
 	// Parses the jog step rate string from the PC - |<rate1>|<rate2> ... - up to 5
-	void ParseJogSteps( const char *str );
+	void ParseJogSteps( char **steps, uint8_t count );
+
+	// Parses the wheel acceleration curve from the PC - <speed1>,<factor1>,<speed2>,<factor2> ... - up to 4 points
+	void ParseWheelAccel( char **fields, uint8_t count );
 
 private:
 	static const uint16_t JOG_INACTIVITY_TIMER = 10000; // 10 seconds of inactivity will exit the jog screen
@@ -179,6 +182,7 @@ private:
 		uint8_t m_bShowStop : 1; // show the stop button
 		uint8_t m_bShowActions : 1; // show the actions to do during idle
 		uint8_t m_bShowAlign : 1; // show Align instead of Step
+		int16_t m_WheelSpeed; // the last wheel speed sent in the MPG mode, in clicks per second
 
 		// previous quantized joystick position
 		int8_t m_OldJoyX;
@@ -193,8 +197,24 @@ private:
 
 	uint8_t m_StepIndex : 3; // current step rate index
 	uint8_t m_StepRateCount : 3;
+	uint8_t m_bWheelSpeedMode : 1; // MPG mode - the PC jogs at a speed that follows the wheel, instead of by whole steps
 	uint16_t m_StepRates[5];
 
+	// Wheel acceleration - the clicks are multiplied by a factor that depends on the wheel speed (clicks per second).
+	// The factor is 1 below the first point, interpolated between the points and constant after the last one
+	static const uint8_t MAX_ACCEL_POINTS = 4;
+	struct AccelPoint
+	{
+		uint8_t speed; // clicks per second
+		uint8_t factor;
+	};
+	AccelPoint m_AccelCurve[MAX_ACCEL_POINTS];
+	uint8_t m_AccelPointCount; // 0 - no acceleration
+
+	int16_t AccelerateWheel( int16_t wheel, uint16_t dt ) const;
+	void UpdateWheelSpeed( unsigned long time );
+	void SendWheelSpeed( int16_t speed );
+
 	enum
 	{
 		BUTTON_X = 0,
@@ -211,22 +231,21 @@ private:
 	static void GetJoystick( int8_t *px, int8_t *py );
 	friend union ScreenTimeshare;
 
-#if PARTIAL_SCREEN_UPDATE
-	struct DrawState
+	enum
 	{
-		float wx, wy, wz;
-		float ox, oy, oz;
-		bool bWorkSpace;
-		bool bShowInches;
-		uint8_t axis : 4;
-		uint8_t bShowStop : 1;
-		uint8_t bShowActions : 1;
-		uint8_t bShowAlign : 1;
-		uint8_t stepIndex : 3;
+		WIDGET_STATUS_LINE,
+		WIDGET_WCS,
+		WIDGET_X,
+		WIDGET_Y,
+		WIDGET_Z,
+		WIDGET_STEP,
+		WIDGET_ACTION, // To 0 or STOP
+		WIDGET_SET0,
+		WIDGET_BACK,
+		WIDGET_COUNT
 	};
 
-	static_assert(sizeof(DrawState) <= sizeof(DrawStateBase::custom), "draw state too big");
-#endif
+	static const WidgetLayout s_Layout[WIDGET_COUNT];
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -240,7 +259,7 @@ public:
 
 	// Parses the MACROS: string from the PC
 	// <hold flags>|<macro1>|<macro2>|<macro3>|<macro4>|<macro5>|<macro6>|<macro7>|
-	void ParseMacros( const char *str );
+	void ParseMacros( char **fields );
 
 private:
 	char m_MacroNames[7][10];
@@ -256,7 +275,7 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 // Default screen - shows status and allows access to homing and sub-menus
-class MainScreen : public BaseScreen
+class MainScreen : public WidgetScreen
 {
 public:
 	virtual void Draw( void ) override;
@@ -276,19 +295,21 @@ private:
 		BUTTON_MACROS = 7,
 	};
 
-#if PARTIAL_SCREEN_UPDATE
-	struct DrawState
+	enum
 	{
-		float wx, wy, wz;
-		float ox, oy, oz;
-		bool bWorkSpace;
-		bool bShowInches;
-		bool bCanShowStop;
-		bool bJobRunning;
+		WIDGET_STATUS_LINE,
+		WIDGET_X,
+		WIDGET_Y,
+		WIDGET_Z,
+		WIDGET_HOME,
+		WIDGET_WCS,
+		WIDGET_PROBE, // Probe or STOP
+		WIDGET_JOB,
+		WIDGET_MACROS,
+		WIDGET_COUNT
 	};
 
-	static_assert(sizeof(DrawState) <= sizeof(DrawStateBase::custom), "draw state too big");
-#endif
+	static const WidgetLayout s_Layout[WIDGET_COUNT];
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -323,13 +344,16 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 // Sub-menu for running a job
-class RunScreen : public BaseScreen
+class RunScreen : public WidgetScreen
 {
 public:
 	virtual void Draw( void ) override;
 	virtual void Update( unsigned long time ) override;
 	virtual void Activate( unsigned long time ) override;
 
+protected:
+	virtual void DrawCustomWidget( uint8_t index, const WidgetLayout &layout, bool bChanged ) override;
+
 private:
 	enum
 	{
@@ -372,19 +396,21 @@ private:
 	uint8_t m_Override : 4; // 0, BUTTON_FEED, BUTTON_SPEED
 	uint8_t m_JobState : 4;
 
-#if PARTIAL_SCREEN_UPDATE
-	struct DrawState
+	enum
 	{
-		float x, y, z;
-		uint16_t f, s;
-		uint16_t rf, rs;
-		bool bShowInches;
-		ScreenState screenState;
-		uint8_t _override;
+		WIDGET_STATUS_LINE,
+		WIDGET_X,
+		WIDGET_Y,
+		WIDGET_Z,
+		WIDGET_RUN, // Run, Pause or Resume
+		WIDGET_STOP, // Back or STOP
+		WIDGET_RPM0,
+		WIDGET_SPEED, // changes redraw the feed and speed row
+		WIDGET_FEED, // draws the feed and speed row
+		WIDGET_COUNT
 	};
 
-	static_assert(sizeof(DrawState) <= sizeof(DrawStateBase::custom), "draw state too big");
-#endif
+	static const WidgetLayout s_Layout[WIDGET_COUNT];
 };
 
 ///////////////////////////////////////////////////////////////////////////////
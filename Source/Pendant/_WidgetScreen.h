@@ -0,0 +1,211 @@
+#pragma once
+
+// Retained widgets for the screens that show live values. The screen describes the position of its widgets with a
+// PROGMEM layout table and sets the value of every widget in Draw. DrawWidgets then draws only the widgets that changed
+// since the last frame, plus the buttons and the status line when their regions are dirty
+
+enum WidgetType : uint8_t
+{
+	WIDGET_STATUS, // status line with the screen title
+	WIDGET_LABEL, // text at col, row. Bold if highlighted
+	WIDGET_COORD, // axis name at column 0 and a value in display units at col, row. Inverted if highlighted
+	WIDGET_BUTTON, // button label, col is the button index. Highlighted buttons require hold. Unused if there's no text
+	WIDGET_CHECKBOX, // check box at col, row
+	WIDGET_CUSTOM, // drawn by the screen in DrawCustomWidget
+};
+
+struct WidgetLayout
+{
+	WidgetType type;
+	uint8_t col;
+	uint8_t row;
+};
+
+// Base class for the screens drawn with widgets
+class WidgetScreen : public BaseScreen
+{
+protected:
+	static const uint8_t MAX_WIDGETS = 10;
+
+	enum
+	{
+		WIDGET_DIRTY = 1, // changed since it was drawn
+		WIDGET_RESTYLED = 2, // the text or the flags changed, not just the value
+		WIDGET_ROMSTR = 4, // the text is in flash
+		WIDGET_HIGHLIGHT = 8,
+		WIDGET_INCHES = 16, // the value of WIDGET_COORD is in 0.001 inch
+	};
+
+	struct Widget
+	{
+		const char *text; // label, button text or axis name
+		int32_t value; // value of WIDGET_COORD, WIDGET_CHECKBOX and WIDGET_CUSTOM, or a key that changes with a text in RAM
+		uint8_t len; // length of the text
+		uint8_t flags;
+		uint8_t drawnLen; // length of the text when it was drawn, to clear the rest when it gets shorter
+	};
+
+	static Widget s_Widgets[MAX_WIDGETS]; // shared by all widget screens, only the active one uses them
+
+	// Sets the text of a status line, label or button. For a text in RAM the key must change when the text changes
+	static void SetText( uint8_t index, const char *text, uint8_t len, bool bHighlight = false, int32_t key = 0 )
+	{
+		SetWidget(index, text, len, key, bHighlight ? WIDGET_HIGHLIGHT : 0);
+	}
+#ifndef EMULATOR
+	static void SetText( uint8_t index, const __FlashStringHelper *text, uint8_t len, bool bHighlight = false )
+	{
+		SetWidget(index, (const char*)text, len, 0, bHighlight ? WIDGET_HIGHLIGHT | WIDGET_ROMSTR : WIDGET_ROMSTR);
+	}
+#endif
+
+	// Shows the button as unused
+	static void SetUnused( uint8_t index ) { SetWidget(index, nullptr, 0, 0, 0); }
+
+	// Sets the axis name and the value of a coordinate, in display units
+#ifdef EMULATOR
+	static void SetCoord( uint8_t index, const char *name, int32_t value, bool bHighlight )
+#else
+	static void SetCoord( uint8_t index, const __FlashStringHelper *name, int32_t value, bool bHighlight )
+#endif
+	{
+		SetWidget(index, (const char*)name, 1, value, (bHighlight ? WIDGET_HIGHLIGHT : 0) | (g_bShowInches ? WIDGET_INCHES : 0) | WIDGET_ROMSTR);
+	}
+
+	// Sets the value of a check box or a custom widget
+	static void SetValue( uint8_t index, int32_t value, bool bHighlight = false )
+	{
+		SetWidget(index, nullptr, 0, value, bHighlight ? WIDGET_HIGHLIGHT : 0);
+	}
+
+	// Draws the widgets that need it. The widget indices match the layout table
+	void DrawWidgets( const WidgetLayout *layouts, uint8_t count );
+
+	// Draws a WIDGET_CUSTOM. bChanged is set if the old contents must be cleared first
+	virtual void DrawCustomWidget( uint8_t index, const WidgetLayout &layout, bool bChanged ) {}
+
+private:
+	static void SetWidget( uint8_t index, const char *text, uint8_t len, int32_t value, uint8_t flags );
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+WidgetScreen::Widget WidgetScreen::s_Widgets[MAX_WIDGETS];
+
+void WidgetScreen::SetWidget( uint8_t index, const char *text, uint8_t len, int32_t value, uint8_t flags )
+{
+	Assert(index < MAX_WIDGETS);
+	Widget &widget = s_Widgets[index];
+	const uint8_t oldFlags = widget.flags & ~(WIDGET_DIRTY | WIDGET_RESTYLED);
+	if (widget.text != text || widget.len != len || oldFlags != flags)
+	{
+		flags |= WIDGET_DIRTY | WIDGET_RESTYLED;
+	}
+	else if (widget.value != value)
+	{
+		flags |= WIDGET_DIRTY;
+	}
+	else
+	{
+		return;
+	}
+	widget.text = text;
+	widget.len = len;
+	widget.value = value;
+	widget.flags = flags | (widget.flags & (WIDGET_DIRTY | WIDGET_RESTYLED)); // keep the changes that weren't drawn yet
+}
+
+void WidgetScreen::DrawWidgets( const WidgetLayout *layouts, uint8_t count )
+{
+	for (uint8_t i = 0; i < count; i++)
+	{
+		WidgetLayout layout;
+		memcpy_P(&layout, layouts + i, sizeof(layout));
+		Widget &widget = s_Widgets[i];
+		const bool bDirty = s_DrawState.bDrawAll || (widget.flags & WIDGET_DIRTY);
+		const bool bChanged = !s_DrawState.bDrawAll && (widget.flags & WIDGET_DIRTY); // must clear the old contents
+		const bool bRestyled = s_DrawState.bDrawAll || (widget.flags & WIDGET_RESTYLED);
+		const bool bHighlight = (widget.flags & WIDGET_HIGHLIGHT) != 0;
+		const bool bRomStr = (widget.flags & WIDGET_ROMSTR) != 0;
+		const int8_t y = g_Rows[layout.row];
+
+		switch (layout.type)
+		{
+			case WIDGET_STATUS:
+#if PARTIAL_SCREEN_UPDATE
+				if (bChanged) ClearRegions(1 << STATUS_REGION);
+#endif
+#ifdef EMULATOR
+				DrawMachineStatus(widget.text, widget.len);
+#else
+				DrawMachineStatus((const __FlashStringHelper*)widget.text, widget.len);
+#endif
+				break;
+
+			case WIDGET_BUTTON:
+#if PARTIAL_SCREEN_UPDATE
+				if (bChanged) ClearRegions(1 << layout.col);
+#endif
+				if (widget.text)
+				{
+					DrawButtonInt(layout.col, widget.text, widget.len, bHighlight, bRomStr);
+				}
+				else
+				{
+					DrawUnusedButtons(1 << layout.col);
+				}
+				break;
+
+			case WIDGET_LABEL:
+				if (!bDirty || !IsRowVisible(layout.row)) continue;
+				if (bChanged && widget.drawnLen > widget.len)
+				{
+					SetDrawColor(0);
+					DrawBox(layout.col*7 + 1 + widget.len*7, y - 1, (widget.drawnLen - widget.len)*7, 10);
+				}
+				SetDrawColor(1);
+				DrawTextInt(layout.col*7 + 1, y, widget.text, bHighlight, bRomStr);
+				widget.drawnLen = widget.len;
+				break;
+
+			case WIDGET_COORD:
+				if (!bDirty || !IsRowVisible(layout.row)) continue;
+				if (bRestyled)
+				{
+					// the axis name, inverted for the current axis
+					SetDrawColor(bHighlight ? 1 : 0);
+					if (bHighlight || bChanged) DrawBox(0, y - 1, 8, 10);
+					SetDrawColor(bHighlight ? 0 : 1);
+					DrawTextInt(1, y, widget.text, false, bRomStr);
+				}
+				{
+					char buf[13];
+					PrintDisplayUnits(buf, widget.value);
+					const uint8_t len = Strlen(buf);
+					SetDrawColor(0);
+					if (bChanged && widget.drawnLen > len)
+					{
+						DrawBox(layout.col*7 + 1 + len*7, y - 1, (widget.drawnLen - len)*7, 10);
+					}
+					SetDrawColor(1);
+					DrawTextInt(layout.col*7 + 1, y, buf, bHighlight, false);
+					widget.drawnLen = len;
+				}
+				break;
+
+			case WIDGET_CHECKBOX:
+				if (!bDirty || !IsRowVisible(layout.row)) continue;
+				SetDrawColor(1);
+				DrawText(layout.col, layout.row, widget.value ? g_StrChecked : g_StrUnchecked);
+				break;
+
+			case WIDGET_CUSTOM:
+				if (!bDirty || !IsRowVisible(layout.row)) continue;
+				SetDrawColor(1);
+				DrawCustomWidget(i, layout, bChanged);
+				break;
+		}
+		widget.flags &= ~(WIDGET_DIRTY | WIDGET_RESTYLED);
+	}
+	SetDrawColor(1);
+}
@@ -1,128 +1,128 @@
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // unused
-	0x00, 0x3F, 0x21, 0x21, 0x21, 0x21, 0x3F, 0x00, // unchecked
-	0x00, 0x3F, 0x21, 0x2D, 0x2D, 0x21, 0x3F, 0x00, // checked
-	0x00, 0x08, 0x08, 0x08, 0x3E, 0x1C, 0x08, 0x00, // hold
-	0x00, 0x00, 0x00, 0x08, 0x14, 0x08, 0x00, 0x00, // placeholder
+	0x7E, 0x42, 0x42, 0x42, 0x42, 0x7E, 0x00, 0x00, // unchecked
+	0x7E, 0x42, 0x5A, 0x5A, 0x42, 0x7E, 0x00, 0x00, // checked
+	0x00, 0x10, 0x30, 0x7E, 0x30, 0x10, 0x00, 0x00, // hold
+	0x00, 0x00, 0x10, 0x28, 0x10, 0x00, 0x00, 0x00, // placeholder
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // unused
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // unused
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // unused
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // unused
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // unused
-	0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, // new line
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, // new line
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // unused
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // unused
-	0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, // new line
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, // new line
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // unused
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // unused
-	0x0C, 0x16, 0x33, 0x33, 0x33, 0x33, 0x1A, 0x0C, // 0 bold
-	0x0C, 0x0E, 0x0F, 0x0C, 0x0C, 0x0C, 0x0C, 0x3F, // 1 bold
-	0x1E, 0x33, 0x33, 0x30, 0x1C, 0x06, 0x03, 0x3F, // 2 bold
-	0x3F, 0x18, 0x0C, 0x1E, 0x38, 0x30, 0x33, 0x1E, // 3 bold
-	0x38, 0x3C, 0x36, 0x33, 0x33, 0x3F, 0x30, 0x30, // 4 bold
-	0x3F, 0x03, 0x03, 0x1F, 0x30, 0x30, 0x33, 0x1E, // 5 bold
-	0x3C, 0x06, 0x03, 0x1F, 0x33, 0x33, 0x33, 0x1E, // 6 bold
-	0x3F, 0x30, 0x18, 0x0C, 0x0C, 0x06, 0x06, 0x06, // 7 bold
-	0x1E, 0x33, 0x33, 0x1E, 0x33, 0x33, 0x33, 0x1E, // 8 bold
-	0x1E, 0x33, 0x33, 0x33, 0x3E, 0x30, 0x18, 0x0F, // 9 bold
-	0x00, 0x66, 0x66, 0x30, 0x18, 0x0C, 0x66, 0x66, // % bold
-	0x3F, 0x03, 0x03, 0x0F, 0x0F, 0x03, 0x03, 0x03, // F bold
-	0x1E, 0x33, 0x03, 0x1E, 0x3C, 0x30, 0x33, 0x1E, // S bold
-	0x33, 0x33, 0x1E, 0x0C, 0x1E, 0x33, 0x33, 0x33, // X bold
-	0x33, 0x33, 0x1E, 0x1E, 0x0C, 0x0C, 0x0C, 0x0C, // Y bold
-	0x3F, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x03, 0x3F, // Z bold
+	0x3C, 0x7E, 0x83, 0xC1, 0x7E, 0x3C, 0x00, 0x00, // 0 bold
+	0x84, 0x86, 0xFF, 0xFF, 0x80, 0x80, 0x00, 0x00, // 1 bold
+	0xC6, 0xE7, 0xB1, 0x91, 0x9F, 0x8E, 0x00, 0x00, // 2 bold
+	0x41, 0xC9, 0x8D, 0x9F, 0xFB, 0x71, 0x00, 0x00, // 3 bold
+	0x38, 0x3C, 0x26, 0x23, 0xFF, 0xFF, 0x00, 0x00, // 4 bold
+	0x4F, 0xCF, 0x89, 0x89, 0xF9, 0x71, 0x00, 0x00, // 5 bold
+	0x7C, 0xFE, 0x8B, 0x89, 0xF9, 0x71, 0x00, 0x00, // 6 bold
+	0x01, 0xE1, 0xF9, 0x1D, 0x07, 0x03, 0x00, 0x00, // 7 bold
+	0x76, 0xFF, 0x89, 0x89, 0xFF, 0x76, 0x00, 0x00, // 8 bold
+	0x8E, 0x9F, 0x91, 0xD1, 0x7F, 0x3E, 0x00, 0x00, // 9 bold
+	0x00, 0xC6, 0xE6, 0x30, 0x18, 0xCE, 0xC6, 0x00, // % bold
+	0xFF, 0xFF, 0x19, 0x19, 0x01, 0x01, 0x00, 0x00, // F bold
+	0x46, 0xCF, 0x99, 0x99, 0xFB, 0x72, 0x00, 0x00, // S bold
+	0xE3, 0xF7, 0x1C, 0x1C, 0xF7, 0xE3, 0x00, 0x00, // X bold
+	0x03, 0x0F, 0xFC, 0xFC, 0x0F, 0x03, 0x00, 0x00, // Y bold
+	0xE1, 0xF1, 0x99, 0x8D, 0x87, 0x83, 0x00, 0x00, // Z bold
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // ' '
-	0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x00, 0x08, // !
-	0x14, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // "
-	0x00, 0x14, 0x14, 0x3E, 0x14, 0x3E, 0x14, 0x14, // #
-	0x00, 0x08, 0x3C, 0x0A, 0x1C, 0x28, 0x1E, 0x08, // $
-	0x00, 0x26, 0x26, 0x10, 0x08, 0x04, 0x32, 0x32, // %
-	0x00, 0x06, 0x09, 0x09, 0x06, 0x29, 0x11, 0x2E, // &
-	0x08, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // '
-	0x10, 0x08, 0x08, 0x04, 0x04, 0x08, 0x08, 0x10, // (
-	0x04, 0x08, 0x08, 0x10, 0x10, 0x08, 0x08, 0x04, // )
-	0x00, 0x00, 0x12, 0x0C, 0x3F, 0x0C, 0x12, 0x00, // *
-	0x00, 0x00, 0x08, 0x08, 0x3E, 0x08, 0x08, 0x00, // +
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x06, // ,
-	0x00, 0x00, 0x00, 0x00, 0x3E, 0x00, 0x00, 0x00, // -
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, // .
-	0x20, 0x20, 0x10, 0x08, 0x08, 0x04, 0x02, 0x02, // /
-	0x0C, 0x12, 0x21, 0x21, 0x21, 0x21, 0x12, 0x0C, // 0
-	0x08, 0x0C, 0x0A, 0x08, 0x08, 0x08, 0x08, 0x3E, // 1
-	0x1E, 0x21, 0x21, 0x20, 0x1C, 0x02, 0x01, 0x3F, // 2
-	0x3F, 0x10, 0x08, 0x1C, 0x20, 0x20, 0x21, 0x1E, // 3
-	0x10, 0x18, 0x14, 0x12, 0x11, 0x3F, 0x10, 0x10, // 4
-	0x3F, 0x01, 0x01, 0x1F, 0x20, 0x20, 0x21, 0x1E, // 5
-	0x3C, 0x02, 0x01, 0x1F, 0x21, 0x21, 0x21, 0x1E, // 6
-	0x3E, 0x20, 0x10, 0x08, 0x08, 0x04, 0x04, 0x04, // 7
-	0x1E, 0x21, 0x21, 0x1E, 0x21, 0x21, 0x21, 0x1E, // 8
-	0x1E, 0x21, 0x21, 0x21, 0x3E, 0x20, 0x10, 0x0F, // 9
-	0x00, 0x00, 0x0C, 0x0C, 0x00, 0x00, 0x0C, 0x0C, // :
-	0x00, 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x06, // ;
-	0x00, 0x10, 0x08, 0x04, 0x02, 0x04, 0x08, 0x10, // <
-	0x00, 0x00, 0x3E, 0x00, 0x00, 0x3E, 0x00, 0x00, // =
-	0x00, 0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02, // >
-	0x1C, 0x22, 0x22, 0x10, 0x08, 0x08, 0x00, 0x08, // ?
-	0x1E, 0x21, 0x39, 0x25, 0x35, 0x29, 0x01, 0x1E, // @
-	0x0C, 0x12, 0x21, 0x21, 0x3F, 0x21, 0x21, 0x21, // A
-	0x1F, 0x22, 0x22, 0x1E, 0x22, 0x22, 0x22, 0x1F, // B
-	0x1E, 0x21, 0x01, 0x01, 0x01, 0x01, 0x21, 0x1E, // C
-	0x1F, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x1F, // D
-	0x3F, 0x01, 0x01, 0x0F, 0x01, 0x01, 0x01, 0x3F, // E
-	0x3F, 0x01, 0x01, 0x0F, 0x01, 0x01, 0x01, 0x01, // F
-	0x1E, 0x21, 0x01, 0x01, 0x39, 0x21, 0x31, 0x2E, // G
-	0x21, 0x21, 0x21, 0x3F, 0x21, 0x21, 0x21, 0x21, // H
-	0x3E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x3E, // I
-	0x38, 0x10, 0x10, 0x10, 0x10, 0x10, 0x11, 0x0E, // J
-	0x11, 0x09, 0x05, 0x03, 0x05, 0x09, 0x11, 0x21, // K
-	0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x3F, // L
-	0x22, 0x36, 0x3E, 0x2A, 0x2A, 0x22, 0x22, 0x22, // M
-	0x21, 0x21, 0x23, 0x25, 0x29, 0x31, 0x21, 0x21, // N
-	0x1E, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x1E, // O
-	0x1F, 0x21, 0x21, 0x1F, 0x01, 0x01, 0x01, 0x01, // P
-	0x1E, 0x21, 0x21, 0x21, 0x21, 0x29, 0x11, 0x2E, // Q
-	0x1F, 0x21, 0x21, 0x1F, 0x05, 0x09, 0x11, 0x21, // R
-	0x1E, 0x21, 0x01, 0x1E, 0x20, 0x20, 0x21, 0x1E, // S
-	0x3E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, // T
-	0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x1E, // U
-	0x22, 0x22, 0x22, 0x14, 0x14, 0x14, 0x08, 0x08, // V
-	0x22, 0x22, 0x22, 0x2A, 0x2A, 0x3E, 0x36, 0x22, // W
-	0x21, 0x21, 0x12, 0x0C, 0x12, 0x21, 0x21, 0x21, // X
-	0x22, 0x22, 0x14, 0x14, 0x08, 0x08, 0x08, 0x08, // Y
-	0x3F, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01, 0x3F, // Z
-	0x1E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x1E, // [
-	0x02, 0x02, 0x04, 0x08, 0x08, 0x10, 0x20, 0x20, // '\'
-	0x1E, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1E, // ]
-	0x08, 0x14, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00, // ^
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3F, // _
-	0x04, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // `
-	0x00, 0x00, 0x1C, 0x20, 0x3C, 0x22, 0x3C, 0x00, // a
-	0x02, 0x02, 0x1E, 0x22, 0x22, 0x22, 0x1E, 0x00, // b
-	0x00, 0x00, 0x3C, 0x02, 0x02, 0x02, 0x3C, 0x00, // c
-	0x20, 0x20, 0x3C, 0x22, 0x22, 0x22, 0x3C, 0x00, // d
-	0x00, 0x00, 0x1C, 0x22, 0x3E, 0x02, 0x3C, 0x00, // e
-	0x18, 0x24, 0x04, 0x04, 0x1E, 0x04, 0x04, 0x00, // f
-	0x00, 0x00, 0x1C, 0x22, 0x22, 0x3C, 0x20, 0x1C, // g
-	0x02, 0x02, 0x1E, 0x22, 0x22, 0x22, 0x22, 0x00, // h
-	0x08, 0x00, 0x0C, 0x08, 0x08, 0x08, 0x1C, 0x00, // i
-	0x10, 0x00, 0x18, 0x10, 0x10, 0x12, 0x0C, 0x00, // j
-	0x02, 0x02, 0x22, 0x12, 0x0E, 0x12, 0x22, 0x00, // k
-	0x0C, 0x08, 0x08, 0x08, 0x08, 0x08, 0x1C, 0x00, // l
-	0x00, 0x00, 0x36, 0x2A, 0x2A, 0x22, 0x22, 0x00, // m
-	0x00, 0x00, 0x1E, 0x22, 0x22, 0x22, 0x22, 0x00, // n
-	0x00, 0x00, 0x1C, 0x22, 0x22, 0x22, 0x1C, 0x00, // o
-	0x00, 0x00, 0x1E, 0x22, 0x22, 0x1E, 0x02, 0x02, // p
-	0x00, 0x00, 0x3C, 0x22, 0x22, 0x3C, 0x20, 0x20, // q
-	0x00, 0x00, 0x1A, 0x06, 0x02, 0x02, 0x02, 0x00, // r
-	0x00, 0x00, 0x3C, 0x02, 0x1C, 0x20, 0x1E, 0x00, // s
-	0x04, 0x04, 0x1E, 0x04, 0x04, 0x24, 0x18, 0x00, // t
-	0x00, 0x00, 0x22, 0x22, 0x22, 0x22, 0x3C, 0x00, // u
-	0x00, 0x00, 0x22, 0x22, 0x22, 0x14, 0x08, 0x00, // v
-	0x00, 0x00, 0x22, 0x22, 0x2A, 0x2A, 0x36, 0x00, // w
-	0x00, 0x00, 0x22, 0x14, 0x08, 0x14, 0x22, 0x00, // x
-	0x00, 0x00, 0x22, 0x22, 0x22, 0x3C, 0x20, 0x1C, // y
-	0x00, 0x00, 0x3E, 0x10, 0x08, 0x04, 0x3E, 0x00, // z
-	0x00, 0x18, 0x04, 0x04, 0x02, 0x04, 0x04, 0x18, // {
-	0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, // |
-	0x00, 0x0C, 0x10, 0x10, 0x20, 0x10, 0x10, 0x0C, // }
-	0x00, 0x00, 0x00, 0x26, 0x19, 0x00, 0x00, 0x00, // ~
-	0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, // 
+	0x00, 0x00, 0x00, 0xBF, 0x00, 0x00, 0x00, 0x00, // !
+	0x00, 0x00, 0x03, 0x00, 0x03, 0x00, 0x00, 0x00, // "
+	0x00, 0x28, 0xFE, 0x28, 0xFE, 0x28, 0x00, 0x00, // #
+	0x00, 0x48, 0x54, 0xFE, 0x54, 0x24, 0x00, 0x00, // $
+	0x00, 0xC6, 0x26, 0x10, 0xC8, 0xC6, 0x00, 0x00, // %
+	0x6C, 0x92, 0x92, 0xAC, 0x40, 0xA0, 0x00, 0x00, // &
+	0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, // '
+	0x00, 0x00, 0x18, 0x66, 0x81, 0x00, 0x00, 0x00, // (
+	0x00, 0x00, 0x81, 0x66, 0x18, 0x00, 0x00, 0x00, // )
+	0x10, 0x54, 0x38, 0x38, 0x54, 0x10, 0x00, 0x00, // *
+	0x00, 0x10, 0x10, 0x7C, 0x10, 0x10, 0x00, 0x00, // +
+	0x00, 0x80, 0xE0, 0x60, 0x00, 0x00, 0x00, 0x00, // ,
+	0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, // -
+	0x00, 0x00, 0xC0, 0xC0, 0x00, 0x00, 0x00, 0x00, // .
+	0x00, 0xC0, 0x20, 0x18, 0x04, 0x03, 0x00, 0x00, // /
+	0x3C, 0x42, 0x81, 0x81, 0x42, 0x3C, 0x00, 0x00, // 0
+	0x00, 0x84, 0x82, 0xFF, 0x80, 0x80, 0x00, 0x00, // 1
+	0xC6, 0xA1, 0x91, 0x91, 0x91, 0x8E, 0x00, 0x00, // 2
+	0x41, 0x81, 0x89, 0x8D, 0x8B, 0x71, 0x00, 0x00, // 3
+	0x30, 0x28, 0x24, 0x22, 0xFF, 0x20, 0x00, 0x00, // 4
+	0x4F, 0x89, 0x89, 0x89, 0x89, 0x71, 0x00, 0x00, // 5
+	0x7C, 0x8A, 0x89, 0x89, 0x89, 0x71, 0x00, 0x00, // 6
+	0x00, 0x01, 0xE1, 0x19, 0x05, 0x03, 0x00, 0x00, // 7
+	0x76, 0x89, 0x89, 0x89, 0x89, 0x76, 0x00, 0x00, // 8
+	0x8E, 0x91, 0x91, 0x91, 0x51, 0x3E, 0x00, 0x00, // 9
+	0x00, 0x00, 0xCC, 0xCC, 0x00, 0x00, 0x00, 0x00, // :
+	0x00, 0x80, 0xEC, 0x6C, 0x00, 0x00, 0x00, 0x00, // ;
+	0x00, 0x10, 0x28, 0x44, 0x82, 0x00, 0x00, 0x00, // <
+	0x00, 0x24, 0x24, 0x24, 0x24, 0x24, 0x00, 0x00, // =
+	0x00, 0x82, 0x44, 0x28, 0x10, 0x00, 0x00, 0x00, // >
+	0x00, 0x06, 0x01, 0xB1, 0x09, 0x06, 0x00, 0x00, // ?
+	0x7E, 0x81, 0x99, 0xA5, 0x95, 0x3E, 0x00, 0x00, // @
+	0xFC, 0x12, 0x11, 0x11, 0x12, 0xFC, 0x00, 0x00, // A
+	0x81, 0xFF, 0x89, 0x89, 0x89, 0x76, 0x00, 0x00, // B
+	0x7E, 0x81, 0x81, 0x81, 0x81, 0x42, 0x00, 0x00, // C
+	0x81, 0xFF, 0x81, 0x81, 0x81, 0x7E, 0x00, 0x00, // D
+	0xFF, 0x89, 0x89, 0x89, 0x81, 0x81, 0x00, 0x00, // E
+	0xFF, 0x09, 0x09, 0x09, 0x01, 0x01, 0x00, 0x00, // F
+	0x7E, 0x81, 0x81, 0x91, 0x51, 0xF2, 0x00, 0x00, // G
+	0xFF, 0x08, 0x08, 0x08, 0x08, 0xFF, 0x00, 0x00, // H
+	0x00, 0x81, 0x81, 0xFF, 0x81, 0x81, 0x00, 0x00, // I
+	0x40, 0x80, 0x80, 0x81, 0x7F, 0x01, 0x00, 0x00, // J
+	0xFF, 0x08, 0x14, 0x22, 0x41, 0x80, 0x00, 0x00, // K
+	0xFF, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00, 0x00, // L
+	0x00, 0xFF, 0x06, 0x1C, 0x06, 0xFF, 0x00, 0x00, // M
+	0xFF, 0x04, 0x08, 0x10, 0x20, 0xFF, 0x00, 0x00, // N
+	0x7E, 0x81, 0x81, 0x81, 0x81, 0x7E, 0x00, 0x00, // O
+	0xFF, 0x09, 0x09, 0x09, 0x09, 0x06, 0x00, 0x00, // P
+	0x7E, 0x81, 0x81, 0xA1, 0x41, 0xBE, 0x00, 0x00, // Q
+	0xFF, 0x09, 0x19, 0x29, 0x49, 0x86, 0x00, 0x00, // R
+	0x46, 0x89, 0x89, 0x89, 0x89, 0x72, 0x00, 0x00, // S
+	0x00, 0x01, 0x01, 0xFF, 0x01, 0x01, 0x00, 0x00, // T
+	0x7F, 0x80, 0x80, 0x80, 0x80, 0x7F, 0x00, 0x00, // U
+	0x00, 0x07, 0x38, 0xC0, 0x38, 0x07, 0x00, 0x00, // V
+	0x00, 0xFF, 0x60, 0x38, 0x60, 0xFF, 0x00, 0x00, // W
+	0xE3, 0x14, 0x08, 0x08, 0x14, 0xE3, 0x00, 0x00, // X
+	0x00, 0x03, 0x0C, 0xF0, 0x0C, 0x03, 0x00, 0x00, // Y
+	0xC1, 0xA1, 0x91, 0x89, 0x85, 0x83, 0x00, 0x00, // Z
+	0x00, 0xFF, 0x81, 0x81, 0x81, 0x00, 0x00, 0x00, // [
+	0x00, 0x03, 0x04, 0x18, 0x20, 0xC0, 0x00, 0x00, // '\'
+	0x00, 0x81, 0x81, 0x81, 0xFF, 0x00, 0x00, 0x00, // ]
+	0x00, 0x04, 0x02, 0x01, 0x02, 0x04, 0x00, 0x00, // ^
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00, 0x00, // _
+	0x00, 0x00, 0x01, 0x02, 0x00, 0x00, 0x00, 0x00, // `
+	0x00, 0x20, 0x54, 0x54, 0x54, 0x78, 0x00, 0x01, // a
+	0x00, 0x7F, 0x44, 0x44, 0x44, 0x38, 0x00, 0x01, // b
+	0x00, 0x38, 0x44, 0x44, 0x44, 0x44, 0x00, 0x01, // c
+	0x00, 0x38, 0x44, 0x44, 0x44, 0x7F, 0x00, 0x01, // d
+	0x00, 0x38, 0x54, 0x54, 0x54, 0x58, 0x00, 0x01, // e
+	0x00, 0x10, 0x7E, 0x11, 0x11, 0x02, 0x00, 0x01, // f
+	0x00, 0x18, 0xA4, 0xA4, 0xA4, 0x78, 0x00, 0x01, // g
+	0x00, 0x7F, 0x04, 0x04, 0x04, 0x78, 0x00, 0x01, // h
+	0x00, 0x00, 0x44, 0x7D, 0x40, 0x00, 0x00, 0x01, // i
+	0x00, 0x20, 0x40, 0x44, 0x3D, 0x00, 0x00, 0x01, // j
+	0x00, 0x7F, 0x10, 0x10, 0x28, 0x44, 0x00, 0x01, // k
+	0x00, 0x00, 0x41, 0x7F, 0x40, 0x00, 0x00, 0x01, // l
+	0x00, 0x7C, 0x04, 0x18, 0x04, 0x7C, 0x00, 0x01, // m
+	0x00, 0x7C, 0x04, 0x04, 0x04, 0x78, 0x00, 0x01, // n
+	0x00, 0x38, 0x44, 0x44, 0x44, 0x38, 0x00, 0x01, // o
+	0x00, 0xFC, 0x24, 0x24, 0x24, 0x18, 0x00, 0x01, // p
+	0x00, 0x18, 0x24, 0x24, 0x24, 0xFC, 0x00, 0x01, // q
+	0x00, 0x7C, 0x08, 0x04, 0x04, 0x00, 0x00, 0x01, // r
+	0x00, 0x48, 0x54, 0x54, 0x54, 0x24, 0x00, 0x01, // s
+	0x00, 0x04, 0x3F, 0x44, 0x44, 0x20, 0x00, 0x01, // t
+	0x00, 0x3C, 0x40, 0x40, 0x40, 0x7C, 0x00, 0x01, // u
+	0x00, 0x1C, 0x20, 0x40, 0x20, 0x1C, 0x00, 0x01, // v
+	0x00, 0x7C, 0x40, 0x30, 0x40, 0x7C, 0x00, 0x01, // w
+	0x00, 0x44, 0x28, 0x10, 0x28, 0x44, 0x00, 0x01, // x
+	0x00, 0x1C, 0xA0, 0xA0, 0xA0, 0x7C, 0x00, 0x01, // y
+	0x00, 0x44, 0x64, 0x54, 0x4C, 0x44, 0x00, 0x01, // z
+	0x00, 0x10, 0x6C, 0x82, 0x82, 0x00, 0x00, 0x00, // {
+	0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00, // |
+	0x00, 0x00, 0x82, 0x82, 0x6C, 0x10, 0x00, 0x00, // }
+	0x10, 0x08, 0x08, 0x10, 0x10, 0x08, 0x00, 0x00, // ~
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, // 
@@ -25,13 +25,28 @@ const WHEEL_JOG_AHEAD_TIME = 600; // up to 600ms of jog time submitted to Grbl
 // To avoid losing any clicks (the machine will move the exact number of clicks), use a very large number like 100000
 const WHEEL_JOG_STOP_TIME = 100; // the jog will stop 100ms after the last click
 
+// In the MPG mode the wheel controls the jog speed. These control how far ahead the jog runs, and how long to wait for
+// the next speed update from the pendant before stopping the jog (the pendant sends one every 100ms while the wheel turns)
+const MPG_JOG_AHEAD_TIME = 200; // up to 200ms of jog time submitted to Grbl
+const MPG_JOG_TIMEOUT = 300; // stop if there is no update for 300ms
+
 // These must match Main.h
 const PENDANT_VERSION = "1.4";
 const PENDANT_BAUD_RATE = 38400;
 
+// After the handshake the connection switches to the highest baud rate supported by both sides (see PENDANT_MAX_BAUD_RATE
+// in Config.h). Set this to PENDANT_BAUD_RATE to always stay at 38400.
+// If the new rate doesn't work, or causes errors, the connection goes back to PENDANT_BAUD_RATE.
+const PENDANT_MAX_BAUD_RATE = 1000000;
+const BAUD_CONFIRM_TIME = 1500; // wait up to 1.5 seconds for the pendant to respond at the new rate. must be longer than BAUD_CONFIRM_TIME in Main.h
+const BAUD_MAX_ERRORS = 3; // go back to PENDANT_BAUD_RATE after 3 corrupted frames or lines
+
 // Must match Input.h
 const JOYSTICK_STEPS = 100;
 
+// In binary mode the status is sent as a delta from the previous one. This controls how often a full status is sent instead.
+const STATUS_KEYFRAME_INTERVAL = 50; // a full status after every 50 delta updates
+
 const COM_LOG_LEVEL = 0; // 0 - none, 1 - commands, 2 - everything, 3 - everything+ACK
 
 const {
@@ -50,11 +65,49 @@ const CHAR_HOLD = String.fromCharCode(0x03);
 const CHAR_ACK = String.fromCharCode(0x1F);
 const MAX_MESSAGE_LENGTH = 50; // send up to 50 bytes to the pendant and then wait for ACK. Arduino has only 64 bytes of buffer for the serial connection
 
+// Binary protocol. Must match Protocol.h
+const USE_BINARY_PROTOCOL = true; // set to false to always use the ASCII protocol
+const FRAME_TEXT = 1;
+const FRAME_TEXT_PART = 2;
+const FRAME_STATUS = 16;
+const FRAME_STATUS2 = 17;
+const FRAME_PONG = 18;
+const FRAME_STATUS_DELTA = 19;
+const FRAME_CREDIT = 32;
+const FRAME_PING = 33;
+const FRAME_JOG_XY = 34;
+const FRAME_JOG_WHEEL = 35;
+const FRAME_RAWJOY = 36;
+const FRAME_RESYNC = 37;
+const MAX_FRAME_TEXT = MAX_MESSAGE_LENGTH - 5; // type, crc16, COBS code and delimiter
+
+// Realtime codes - single bytes from the pendant that bypass the line and frame parsing. Must match Protocol.h
+const REALTIME_ABORT = 0x80;
+const REALTIME_STOP = 0x81;
+const REALTIME_JOB_STOP = 0x82;
+const REALTIME_FEED_HOLD = 0x83;
+const REALTIME_JOG_CANCEL = 0x84;
+
+var g_bBinaryMode = false; // switched on after the pendant responds with PROTO:B
+var g_TxWindow; // in binary mode, how many bytes can be sent without waiting for credit from the pendant
+var g_TxInFlight = 0; // bytes sent, but not credited back yet
+var g_LastCredit = 0; // the last credit byte received from the pendant
+
+var g_BaudRate = PENDANT_BAUD_RATE; // current baud rate of the port
+var g_bBaudPending = false; // waiting for the response to BAUD:
+var g_bBaudFallback = false; // the high baud rate failed once, don't try it again
+var g_BaudTimer; // waiting for the pendant to confirm the new baud rate
+var g_BadFrameCount = 0; // corrupted frames and lines since the baud rate switch
+var g_RxBytes = []; // bytes received since the last line or frame delimiter
+
 var g_StatusCounter = 0;
 var g_JobProgress;
 // Status cache - store the last sent value to avoid spamming when nothing changes
 var g_LastStatusStr = undefined;
 var g_LastStatus2Str = undefined;
+var g_StatusSeq = 0; // sequence number of the last status frame
+var g_StatusBase = undefined; // values sent with the last status frame. undefined forces a full keyframe
+var g_StatusDeltaCount = 0; // delta frames since the last keyframe
 
 var g_PendantSettings = GetDefaultSettings();
 var g_PendantRomSettings = GetDefaultRomSettings();
@@ -104,6 +157,7 @@ function GetDefaultSettings()
 		displayUnits: "mm",
 		wheelStepsMm: [1, 0.1, 0.01],
 		wheelStepsIn: [0.1, 0.01, 0.001],
+		wheelAccel: [], // [clicks per second, step multiplier]. disabled by default, so the jog distance doesn't change unless enabled
 		pauseSpindle: false,
 		jobChecklist: "Remove Probe|Turn On Spindle",
 		safeLimitsEnabled: true,
@@ -158,6 +212,7 @@ function GetDefaultRomSettings()
 		pendantName: "Controlinator 3000",
 		calibrationX: [0, 1023, 512-64, 512+64],
 		calibrationY: [0, 1023, 512-64, 512+64],
+		joyCurve: GetJoystickCurve("linear"),
 	};
 }
 
@@ -165,12 +220,12 @@ function ClearStatusCache()
 {
 	g_LastStatusStr = undefined;
 	g_LastStatus2Str = undefined;
+	g_StatusBase = undefined;
 }
 
-// Generates a string for the main status
-function GenerateStatusString(s)
+// Returns the machine status as a value from g_StatusMap
+function GetPendantStatus(s)
 {
-	// main status string - STATUS:<grbl status>|workX,workY,workZ|feed%,rpm%,realFeed,realRpm
 	var status;
 	if (s.comms.connectionStatus == 0)
 	{
@@ -183,7 +238,7 @@ function GenerateStatusString(s)
 	else
 	{
 		status = g_StatusMap[s.comms.runStatus];
-		if (status == g_StatusMap.Running && (g_JogXYLocation != undefined || g_JogWQueue != undefined || g_ProbeJog != undefined))
+		if (status == g_StatusMap.Running && (g_JogXYLocation != undefined || g_JogWQueue != undefined || g_JogVLocation != undefined || g_ProbeJog != undefined))
 		{
 			status = g_StatusMap.Jog;
 		}
@@ -196,7 +251,14 @@ function GenerateStatusString(s)
 	{
 		status = 0;
 	}
+	return status;
+}
 
+// Generates a string for the main status
+function GenerateStatusString(s)
+{
+	// main status string - STATUS:<grbl status>|workX,workY,workZ|feed%,rpm%,realFeed,realRpm
+	var status = GetPendantStatus(s);
 	var str = "STATUS:" + status + "|"
 		+ s.machine.position.work.x.toFixed(3) + ","
 		+ s.machine.position.work.y.toFixed(3) + ","
@@ -212,8 +274,8 @@ function GenerateStatusString(s)
 	return str;
 }
 
-// Generates a string for the secondary status (values that change less often)
-function GenerateStatus2String(s)
+// Returns the probe state bits for the secondary status
+function GetProbeState(s)
 {
 	var tlo = g_PendantSettings.zProbe.style == "default" ? 0 : 1;
 	if (g_PendantSettings.toolProbe.style != "disable")
@@ -226,6 +288,13 @@ function GenerateStatus2String(s)
 			tlo += 8;
 		}
 	}
+	return tlo;
+}
+
+// Generates a string for the secondary status (values that change less often)
+function GenerateStatus2String(s)
+{
+	var tlo = GetProbeState(s);
 	if (tlo > 9)
 	{
 		tlo = String.fromCharCode(55 + tlo);
@@ -243,6 +312,90 @@ function GenerateStatus2String(s)
 	return str;
 }
 
+// Converts a value to uint16 for the binary frames
+function ToUint16(value)
+{
+	return Math.min(Math.max(Math.round(Number(value)), 0), 65535);
+}
+
+// Returns the main status values as integers, in the order used by the binary frames. Must match STATUS_FIELD_ in Main.h
+function GetStatusValues(s)
+{
+	var status = GetPendantStatus(s);
+	return [
+		status,
+		Math.round(s.machine.position.work.x * 1000),
+		Math.round(s.machine.position.work.y * 1000),
+		Math.round(s.machine.position.work.z * 1000),
+		ToUint16(g_TargetFeedRate != undefined ? g_TargetFeedRate : s.machine.overrides.feedOverride),
+		ToUint16(g_TargetSpeedRate != undefined ? g_TargetSpeedRate : s.machine.overrides.spindleOverride),
+		ToUint16(s.machine.overrides.realFeed),
+		ToUint16(s.machine.overrides.realSpindle),
+		status == g_StatusMap.Run && g_JobProgress != undefined ? Math.round(g_JobProgress) : -1,
+	];
+}
+
+// Generates a binary frame for the main status. It is either a full keyframe (see ParseStatusFrame in Main.h)
+// or only the changes since the previous frame (see ParseStatusDeltaFrame)
+function GenerateStatusFrame(s)
+{
+	var values = GetStatusValues(s);
+	g_StatusSeq = (g_StatusSeq + 1) & 0xFF;
+	if (!g_bBinaryMode || g_StatusBase == undefined || g_StatusDeltaCount >= STATUS_KEYFRAME_INTERVAL)
+	{
+		var buf = Buffer.alloc(23);
+		buf.writeUInt8(values[0], 0);
+		buf.writeInt32LE(values[1], 1);
+		buf.writeInt32LE(values[2], 5);
+		buf.writeInt32LE(values[3], 9);
+		buf.writeUInt16LE(values[4], 13);
+		buf.writeUInt16LE(values[5], 15);
+		buf.writeUInt16LE(values[6], 17);
+		buf.writeUInt16LE(values[7], 19);
+		buf.writeInt8(values[8], 21);
+		buf.writeUInt8(g_StatusSeq, 22);
+		g_StatusBase = g_bBinaryMode ? values : undefined; // the keyframe may end up sent as text if not in binary mode yet
+		g_StatusDeltaCount = 0;
+		return {type: FRAME_STATUS, payload: buf};
+	}
+
+	// delta frame - <seq> <mask> followed by a zigzag varint for every changed value
+	var bytes = [g_StatusSeq, 0, 0];
+	var mask = 0;
+	for (var i = 0; i < values.length; i++)
+	{
+		var delta = values[i] - g_StatusBase[i];
+		if (delta != 0)
+		{
+			mask |= 1 << i;
+			var zigzag = delta >= 0 ? delta * 2 : -delta * 2 - 1;
+			while (zigzag >= 0x80)
+			{
+				bytes.push((zigzag % 0x80) | 0x80);
+				zigzag = Math.floor(zigzag / 0x80);
+			}
+			bytes.push(zigzag);
+		}
+	}
+	bytes[1] = mask & 0xFF;
+	bytes[2] = mask >> 8;
+	g_StatusBase = values;
+	g_StatusDeltaCount++;
+	return {type: FRAME_STATUS_DELTA, payload: Buffer.from(bytes)};
+}
+
+// Generates a binary frame payload for the secondary status (see ParseStatus2Frame in Main.h)
+function GenerateStatus2Frame(s)
+{
+	var buf = Buffer.alloc(14);
+	buf.writeUInt8((lastJobStartTime ? 1 : 0) | (s.machine.modals.homedRecently ? 2 : 0) | (s.machine.inputs.includes('P') ? 4 : 0), 0);
+	buf.writeUInt8(GetProbeState(s), 1);
+	buf.writeInt32LE(Math.round(s.machine.position.offset.x * 1000), 2);
+	buf.writeInt32LE(Math.round(s.machine.position.offset.y * 1000), 6);
+	buf.writeInt32LE(Math.round(s.machine.position.offset.z * 1000), 10);
+	return buf;
+}
+
 // Sends the status strings to the pendant
 function PushStatus(status)
 {
@@ -251,14 +404,14 @@ function PushStatus(status)
 		var statusStr = GenerateStatusString(status);
 		if (g_LastStatusStr != statusStr)
 		{
-			WritePort(statusStr);
+			WritePortLatest("STATUS", statusStr, () => GenerateStatusFrame(status));
 			g_LastStatusStr = statusStr;
 		}
 
 		statusStr = GenerateStatus2String(status);
 		if (g_LastStatus2Str != statusStr)
 		{
-			WritePort(statusStr);
+			WritePortLatest("STATUS2", statusStr, () => ({type: FRAME_STATUS2, payload: GenerateStatus2Frame(status)}));
 			g_LastStatus2Str = statusStr;
 		}
 	}
@@ -391,13 +544,63 @@ function HandleJobComplete(data)
 // Responds to a handshake command
 function HandleHandshake()
 {
+	clearTimeout(g_BaudTimer);
+	g_BaudTimer = undefined;
+	g_bBaudPending = false;
 	g_PendantPort.flush();
 	g_SerialQueue = [];
 	g_bSerialPending = false;
+	g_bBinaryMode = false; // the pendant always starts with the ASCII protocol
 	WritePort("");
+	WritePort(USE_BINARY_PROTOCOL ? "PROTO:B" : "PROTO:A"); // the rest of the queue waits for the response. also enables the realtime codes
 	ClearStatusCache();
 	PushSettings(false);
 	PushStatus(laststatus);
+	WritePort("SETTINGS");
+}
+
+// Changes the baud rate of the port
+function SetPortBaudRate(rate, callback)
+{
+	g_BaudRate = rate;
+	g_BadFrameCount = 0;
+	g_PendantPort.update({baudRate: rate}, callback);
+}
+
+// Asks the pendant to switch to a higher baud rate. The handshake continues after the response
+function RequestBaudRate()
+{
+	g_PendantPort.flush();
+	g_SerialQueue = [];
+	g_bSerialPending = false;
+	g_bBaudPending = true;
+	WritePort("BAUD:" + PENDANT_MAX_BAUD_RATE);
+}
+
+// Goes back to PENDANT_BAUD_RATE when the higher rate doesn't work. The pendant does the same on its own
+function FallbackBaudRate()
+{
+	printLog("<span class='fg-darkRed'>[ pendant ] </span><span class='fg-blue'>Communication failed at " + g_BaudRate + " baud. Switching back to " + PENDANT_BAUD_RATE + "</span>")
+	g_bBaudFallback = true;
+	g_bBinaryMode = false;
+	g_SerialQueue = [];
+	g_bSerialPending = false;
+	clearTimeout(g_BaudTimer);
+
+	// keep repeating the handshake until the pendant responds. it gives up on the current rate after a few corrupted
+	// commands, or after 10 seconds without a PING
+	var attempts = 0;
+	g_BaudTimer = setInterval(function()
+	{
+		if (++attempts > 15)
+		{
+			printLog("<span class='fg-darkRed'>[ pendant ] </span><span class='fg-red'>Lost connection</span>")
+			DisconnectPendant();
+			return;
+		}
+		g_PendantPort.write("PEN\n");
+	}, 1000);
+	SetPortBaudRate(PENDANT_BAUD_RATE, function() { g_PendantPort.write("PEN\n"); });
 }
 
 const MAX_BUTTON_SIZE = 14; // must match the DialogScreen class
@@ -482,6 +685,10 @@ function PushSettings(pushRomSettings)
 		WritePort(str);
 	}
 
+	// wheel acceleration
+	var str = "WHEELACCEL:" + g_PendantSettings.wheelAccel.map(p => p[0].toFixed(0) + "," + p[1].toFixed(0)).join(",");
+	WritePort(str);
+
 	// macros
 	var str = "";
 	var flags = 0;
@@ -519,6 +726,7 @@ function PushSettings(pushRomSettings)
 			+ g_PendantRomSettings.calibrationY[2] + ","
 			+ g_PendantRomSettings.calibrationY[3] + ","
 			+ g_PendantRomSettings.calibrationY[1]);
+		WritePort("JOYCURVE:" + g_PendantRomSettings.joyCurve.join(","));
 	}
 }
 
@@ -618,6 +826,14 @@ var g_JogWTimer;
 var g_LastWheelMoveTime;
 var g_ErrorListeners;
 
+// Jogging with the wheel in the MPG mode
+var g_JogVAxis; // 'X', 'Y' or 'Z'
+var g_JogVSpeed = 0; // requested speed in mm/sec, negative for the negative direction
+var g_JogVLocation; // the last submitted target for g_JogVAxis in MCS. always in mm
+var g_JogVTimer;
+var g_JogVTime; // time of the last submitted jog
+var g_LastJogVTime; // time of the last speed update from the pendant
+
 // Jogging with joystick
 var g_JogXYLocation; // last known joystick jog location in MCS. always in mm
 var g_JogXYTimer;
@@ -758,6 +974,73 @@ function UpdateJogW()
 	}
 }
 
+// Stops the MPG jog
+function EndJogV()
+{
+	if (g_JogVTimer != undefined)
+	{
+		clearInterval(g_JogVTimer);
+		g_JogVTimer = undefined;
+	}
+	if (g_JogVLocation != undefined && !IsStableIdle())
+	{
+		socket.emit('stop', {stop: false, jog: true, abort: false});
+	}
+	g_JogVAxis = undefined;
+	g_JogVSpeed = 0;
+	g_JogVLocation = undefined;
+}
+
+// Called periodically to extend the MPG jog with the distance traveled at the current wheel speed
+function UpdateJogV()
+{
+	var t = Date.now();
+	if (t - g_LastJogVTime > MPG_JOG_TIMEOUT)
+	{
+		// lost contact with the pendant, don't keep running
+		EndJogV();
+		return;
+	}
+
+	var axisL = g_JogVAxis.toLowerCase();
+	var current = laststatus.machine.position.work[axisL] + laststatus.machine.position.offset[axisL]; // current absolute position
+	if (g_JogVLocation == undefined)
+	{
+		if (!IsStableIdle())
+		{
+			return;
+		}
+		g_LastBusyTime = Date.now(); // force state as busy
+		g_JogVLocation = current;
+		g_JogVTime = t - 100; // start with 100ms of travel
+	}
+
+	var feedT;
+	switch (g_JogVAxis)
+	{
+		case "X": feedT = grblParams["$110"]; break;
+		case "Y": feedT = grblParams["$111"]; break;
+		case "Z": feedT = grblParams["$112"]; break;
+	}
+	var feed = Math.min(Math.abs(g_JogVSpeed) * 60, feedT); // mm/min
+	var dt = Math.min(t - g_JogVTime, MPG_JOG_AHEAD_TIME) / 1000;
+	g_JogVTime = t;
+
+	if (Math.abs(g_JogVLocation - current) > feed * MPG_JOG_AHEAD_TIME / 60000)
+	{
+		return; // have enough for MPG_JOG_AHEAD_TIME
+	}
+
+	var newValue = ClampSafeAbsoluteMove(g_JogVLocation, Math.sign(g_JogVSpeed) * feed * dt / 60, g_JogVAxis, false);
+	if (newValue != g_JogVLocation)
+	{
+		// absolute machine move, mm
+		var gcode = "$J=G53 G90 G21 " + g_JogVAxis + newValue.toFixed(3) + " F" + feed.toFixed(0);
+		sendGcode(gcode);
+		g_JogVLocation = newValue;
+	}
+}
+
 // Begins jogging with the joystick
 function BeginJogXY()
 {
@@ -847,6 +1130,7 @@ function HandleJogCommand(command)
 	// 0LX - go to work zero on X
 	// RIGX0.010 - round X to 0.010 inches in global space (must be idle)
 	// WMX2*0.10 - wheel X by 2*0.10mm (must be idle or jogging)
+	// VMX-20*0.10 - MPG jog X at -20*0.10mm per second, 0 to stop
 	// JXY-2,3 - joystick is at -2,3
 
 	if (command[0] == '0')
@@ -1006,6 +1290,37 @@ function HandleJogCommand(command)
 		return;
 	}
 
+	if (command[0] == 'V')
+	{
+		// hand wheel in the MPG mode
+		var units = command[1]; // M or I
+		if (units != 'I' && units != 'M') { return; }
+
+		var axis = command[2]; // X/Y/Z
+		if (axis < 'X' || axis > 'Z') { return; }
+
+		var mul = command.indexOf('*');
+		var speed = Number(command.substring(3, mul)) * Number(command.substring(mul + 1)) * (units == 'I' ? 25.4 : 1); // mm/sec
+		if (isNaN(speed)) { return; }
+		g_LastJogVTime = Date.now();
+
+		if (speed == 0 || axis != g_JogVAxis || Math.sign(speed) != Math.sign(g_JogVSpeed))
+		{
+			// the wheel stopped or reversed, or the axis is switched. stop the current jog right away
+			EndJogV();
+			if (speed == 0) { return; }
+		}
+
+		g_JogVAxis = axis;
+		g_JogVSpeed = speed;
+		if (g_JogVTimer == undefined)
+		{
+			UpdateJogV();
+			g_JogVTimer = setInterval(UpdateJogV, 50);
+		}
+		return;
+	}
+
 	if (command.startsWith("JXY"))
 	{
 		// joystick input
@@ -1645,11 +1960,17 @@ function PendantComHandler(data)
 	if (data == CHAR_ACK)
 	{
 		if (COM_LOG_LEVEL >= 3) { console.log("COM: ", "<ACK>"); }
+		if (g_bBaudPending)
+		{
+			// an older pendant doesn't know BAUD:. continue at the current rate
+			HandleHandshake();
+			return;
+		}
 		SendPortMsg();
 		return;
 	}
 
-	if (COM_LOG_LEVEL >= 2 || (COM_LOG_LEVEL == 1 && data != "PING" && !data.startsWith("RAWJOY:") && !data.startsWith("JOG:W") && !data.startsWith("JOG:JXY")))
+	if (COM_LOG_LEVEL >= 2 || (COM_LOG_LEVEL == 1 && data != "PING" && !data.startsWith("RAWJOY:") && !data.startsWith("JOG:W") && !data.startsWith("JOG:V") && !data.startsWith("JOG:JXY")))
 	{
 		console.log("COM: ", data);
 	}
@@ -1684,11 +2005,62 @@ function PendantComHandler(data)
 
 		return;
 	}
+	if (data.startsWith("JOYCURVE:"))
+	{
+		if (COM_LOG_LEVEL >= 1) { console.log("#JOYCURVE#"); }
+		var curve = data.substring(9).split(',').map(Number);
+		if (IsValidJoystickCurve(curve))
+		{
+			g_PendantRomSettings.joyCurve = curve;
+		}
+		return;
+	}
+
+	if (data.startsWith("BAUD:"))
+	{
+		var rate = Number(data.substring(5));
+		if (COM_LOG_LEVEL >= 1) { console.log("#BAUD#", rate); }
+		g_bBaudPending = false;
+		if (rate > 0 && rate != g_BaudRate)
+		{
+			// switch and confirm the new rate with another handshake
+			SetPortBaudRate(rate, function() { g_PendantPort.write("PEN\n"); });
+			g_BaudTimer = setTimeout(FallbackBaudRate, BAUD_CONFIRM_TIME);
+		}
+		else
+		{
+			HandleHandshake();
+		}
+		return;
+	}
+
+	if (data.startsWith("PROTO:"))
+	{
+		if (COM_LOG_LEVEL >= 1) { console.log("#PROTO#"); }
+		g_bBinaryMode = data.startsWith("PROTO:B");
+		g_TxWindow = Number(data.substring(7)) || 60;
+		g_TxInFlight = 0;
+		g_LastCredit = 0;
+		SendPortMsg(); // the pendant doesn't ACK the PROTO: command, this response is used instead
+		return;
+	}
 
 	// heartbeat
 	if (data == "PING")
 	{
-		WritePort("PONG");
+		QueuePortMsg({text: "PONG", pos: 0, type: FRAME_PONG, payload: [], key: "PONG"}, true);
+		return;
+	}
+
+	// display cost, sent when the pendant is built with SCREEN_BENCHMARK
+	if (data.startsWith("BENCH:"))
+	{
+		var bench = data.substring(6).split(',');
+		var frames = Number(bench[1]) || 1;
+		console.log("#BENCH#", bench[0] == "S" ? "shadow buffer" : "manual tracking", "frames:", Number(bench[1]),
+			"draw us/frame:", Math.round(Number(bench[2]) / frames), "flush us/frame:", Math.round(Number(bench[3]) / frames),
+			"tiles/frame:", (Number(bench[4]) / frames).toFixed(1), "I2C bytes/frame:", Math.round(Number(bench[5]) / frames),
+			"draw calls/frame:", (Number(bench[6]) / frames).toFixed(1), "skipped loops:", Number(bench[7]));
 		return;
 	}
 
@@ -1885,56 +2257,362 @@ function PendantComHandler(data)
 		}
 		return;
 	}
+
+	// unknown line. in ASCII mode it is likely corrupted (the binary frames are checked with the CRC)
+	if (!g_bBinaryMode && g_BaudRate != PENDANT_BAUD_RATE && ++g_BadFrameCount >= BAUD_MAX_ERRORS)
+	{
+		FallbackBaudRate();
+	}
 }
 
-var g_SerialQueue = []; // queued up messages to send to the port
+var g_SerialQueue = []; // queued up messages to send to the port - {text, pos, type, payload, key, getFrame}
 var g_bSerialPending = false;
 
-// Sends the next message in the queue to the port
-function SendPortMsg()
+// Computes the CRC-16/CCITT of an array of bytes
+function Crc16(bytes)
 {
-	if (g_SerialQueue.length == 0)
+	var crc = 0xFFFF;
+	for (const b of bytes)
+	{
+		crc ^= b << 8;
+		for (var i = 0; i < 8; i++)
+		{
+			crc = ((crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1) & 0xFFFF;
+		}
+	}
+	return crc;
+}
+
+// Builds a COBS-encoded binary frame, including the CRC and the 0 delimiter
+function EncodeFrame(type, payload)
+{
+	var raw = [type].concat(Array.from(payload));
+	var crc = Crc16(raw);
+	raw.push(crc & 0xFF, crc >> 8);
+	var out = [0];
+	var codeIdx = 0;
+	for (const b of raw)
+	{
+		if (b == 0)
+		{
+			out[codeIdx] = out.length - codeIdx;
+			codeIdx = out.length;
+			out.push(0);
+		}
+		else
+		{
+			out.push(b);
+		}
+	}
+	out[codeIdx] = out.length - codeIdx;
+	out.push(0);
+	return Buffer.from(out);
+}
+
+// Decodes a COBS-encoded binary frame (without the 0 delimiter). Returns undefined if the frame is corrupted
+function DecodeFrame(bytes)
+{
+	var raw = [];
+	var i = 0;
+	while (i < bytes.length)
+	{
+		var code = bytes[i++];
+		if (code == 0 || i + code - 1 > bytes.length)
+		{
+			return undefined;
+		}
+		for (var j = 1; j < code; j++)
+		{
+			raw.push(bytes[i++]);
+		}
+		if (code < 0xFF && i < bytes.length)
+		{
+			raw.push(0);
+		}
+	}
+	if (raw.length < 3 || Crc16(raw.slice(0, raw.length - 2)) != (raw[raw.length - 2] | (raw[raw.length - 1] << 8)))
+	{
+		return undefined;
+	}
+	return {type: raw[0], payload: Buffer.from(raw.slice(1, raw.length - 2))};
+}
+
+// Handles a binary frame from the pendant. The typed frames are converted to the equivalent ASCII commands
+function HandlePendantFrame(bytes)
+{
+	var frame = DecodeFrame(bytes);
+	if (frame == undefined)
+	{
+		if (COM_LOG_LEVEL >= 1) { console.log("COM: ", "<bad frame>"); }
+		if (g_BaudRate != PENDANT_BAUD_RATE && ++g_BadFrameCount >= BAUD_MAX_ERRORS)
+		{
+			FallbackBaudRate();
+		}
+		return;
+	}
+
+	// the last byte is the credit - the number of bytes the pendant has received so far, modulo 256
+	var p = frame.payload;
+	if (p.length == 0)
 	{
-		g_bSerialPending = false;
 		return;
 	}
+	var credit = p[p.length - 1];
+	p = p.subarray(0, p.length - 1);
+	g_TxInFlight = Math.max(g_TxInFlight - ((credit - g_LastCredit) & 0xFF), 0);
+	g_LastCredit = credit;
+
+	switch (frame.type)
+	{
+		case FRAME_CREDIT:
+			if (COM_LOG_LEVEL >= 3) { console.log("COM: ", "<CREDIT>", g_TxInFlight); }
+			break;
+
+		case FRAME_TEXT:
+			PendantComHandler(p.toString('latin1'));
+			break;
+
+		case FRAME_PING:
+			PendantComHandler("PING");
+			break;
+
+		case FRAME_JOG_XY:
+			if (p.length >= 2)
+			{
+				PendantComHandler("JOG:JXY" + p.readInt8(0) + "," + p.readInt8(1));
+			}
+			break;
+
+		case FRAME_JOG_WHEEL:
+			if (p.length >= 6)
+			{
+				var inches = p[0] == 0x49; // 'I'
+				var step = p.readUInt16LE(4);
+				PendantComHandler("JOG:W" + (inches ? "I" : "M") + String.fromCharCode(p[1]) + p.readInt16LE(2) + "*" + (inches ? (step / 1000).toFixed(3) : (step / 100).toFixed(2)));
+			}
+			break;
+
+		case FRAME_RESYNC:
+			if (COM_LOG_LEVEL >= 1) { console.log("#RESYNC#"); }
+			g_LastStatusStr = undefined;
+			g_StatusBase = undefined;
+			PushStatus(laststatus);
+			break;
+
+		case FRAME_RAWJOY:
+			if (p.length >= 4)
+			{
+				PendantComHandler("RAWJOY:" + p.readUInt16LE(0) + "," + p.readUInt16LE(2));
+			}
+			break;
+	}
 
-	var text = g_SerialQueue[0];
-	g_SerialQueue.splice(0, 1);
-	g_PendantPort.write(text);
-	g_bSerialPending = true;
-	if (text != "PONG\n")
+	if (g_bBinaryMode)
 	{
-		if (COM_LOG_LEVEL >= 2) { console.log("SEND: ", text.trim()); }
+		SendPortMsg();
 	}
 }
 
-// Sends a string to the pendant
-function WritePort(text)
+// Handles a realtime code from the pendant. Same as the equivalent text commands, but without waiting for the line
+function HandleRealtimeCode(code)
 {
-	if (g_PendantPort)
+	if (COM_LOG_LEVEL >= 1) { console.log("COM: ", "<REALTIME " + code.toString(16) + ">"); }
+	switch (code)
 	{
-		if (g_SerialQueue.length >= 10)
+		case REALTIME_ABORT:
+			socket.emit('stop', {stop: false, jog: false, abort: true});
+			break;
+
+		case REALTIME_STOP:
+			SmartStop();
+			break;
+
+		case REALTIME_JOB_STOP:
+			HandleJobCommand("STOP");
+			break;
+
+		case REALTIME_FEED_HOLD:
+			HandleJobCommand("PAUSE");
+			break;
+
+		case REALTIME_JOG_CANCEL:
+			HandleJogCommand("JXY0,0");
+			break;
+	}
+}
+
+// Receives raw data from the pendant and splits it into lines (ASCII protocol) or frames (binary protocol)
+function PendantDataHandler(data)
+{
+	for (const b of data)
+	{
+		if (!g_bBinaryMode)
 		{
-			return; // only queue up to 10 messages. the rest are dropped
+			if (b >= REALTIME_ABORT && b <= REALTIME_JOG_CANCEL)
+			{
+				HandleRealtimeCode(b); // can arrive in the middle of a line
+			}
+			else if (b == 0x0A)
+			{
+				var line = Buffer.from(g_RxBytes).toString('latin1');
+				g_RxBytes = [];
+				PendantComHandler(line);
+			}
+			else
+			{
+				g_RxBytes.push(b);
+			}
 		}
-		while (true)
+		else if (b == 0)
 		{
-			if (text.length < MAX_MESSAGE_LENGTH)
+			var bytes = g_RxBytes;
+			g_RxBytes = [];
+			if (bytes.length == 1 && bytes[0] >= REALTIME_ABORT && bytes[0] <= REALTIME_JOG_CANCEL)
 			{
-				g_SerialQueue.push(text + "\n");
-				break;
+				HandleRealtimeCode(bytes[0]); // too short to be a frame
+			}
+			else
+			{
+				HandlePendantFrame(bytes);
 			}
-			g_SerialQueue.push(text.substring(0, MAX_MESSAGE_LENGTH - 1) + CHAR_ACK);
-			text = text.substring(MAX_MESSAGE_LENGTH - 1);
 		}
-		if (!g_bSerialPending)
+		else
 		{
-			SendPortMsg();
+			g_RxBytes.push(b);
+			if (b == 0x0A)
+			{
+				// a restarted pendant is back to the ASCII protocol and sends DANT: on its own
+				var line = Buffer.from(g_RxBytes).toString('latin1');
+				var pos = line.indexOf("DANT:");
+				if (pos >= 0)
+				{
+					g_RxBytes = [];
+					g_bBinaryMode = false;
+					PendantComHandler(line.substring(pos));
+				}
+			}
+			if (g_RxBytes.length > 256)
+			{
+				g_RxBytes = []; // garbage
+			}
 		}
 	}
 }
 
+// Sends the queued messages to the port. The ASCII protocol sends one message (or one part of a long message) and
+// waits for ACK. The binary protocol sends as many frames as fit in the pendant's receive window
+function SendPortMsg()
+{
+	while (g_SerialQueue.length > 0)
+	{
+		var msg = g_SerialQueue[0];
+		var pos;
+		var data;
+		if (g_bBinaryMode && msg.getFrame)
+		{
+			// the frame is generated as late as possible, so a status delta is relative to the previous status that was really sent
+			var frame = msg.getFrame();
+			msg.type = frame.type;
+			msg.payload = frame.payload;
+			msg.getFrame = undefined;
+			msg.bEncoded = true; // can't be replaced any more
+		}
+		if (g_bBinaryMode && msg.type != undefined)
+		{
+			data = EncodeFrame(msg.type, msg.payload);
+			pos = msg.text.length;
+		}
+		else if (g_bBinaryMode)
+		{
+			var part = msg.text.substring(msg.pos, msg.pos + MAX_FRAME_TEXT);
+			pos = msg.pos + part.length;
+			data = EncodeFrame(pos < msg.text.length ? FRAME_TEXT_PART : FRAME_TEXT, Buffer.from(part, 'latin1'));
+		}
+		else if (msg.text.length - msg.pos < MAX_MESSAGE_LENGTH)
+		{
+			data = msg.text.substring(msg.pos) + "\n";
+			pos = msg.text.length;
+		}
+		else
+		{
+			data = msg.text.substring(msg.pos, msg.pos + MAX_MESSAGE_LENGTH - 1) + CHAR_ACK;
+			pos = msg.pos + MAX_MESSAGE_LENGTH - 1;
+		}
+
+		if (g_bBinaryMode && g_TxInFlight > 0 && g_TxInFlight + data.length > g_TxWindow)
+		{
+			break; // wait for credit
+		}
+
+		msg.pos = pos;
+		if (msg.pos >= msg.text.length)
+		{
+			g_SerialQueue.splice(0, 1);
+		}
+		g_PendantPort.write(data);
+		if (msg.text != "PONG")
+		{
+			if (COM_LOG_LEVEL >= 2) { console.log("SEND: ", msg.text); }
+		}
+		if (!g_bBinaryMode)
+		{
+			g_bSerialPending = true;
+			return;
+		}
+		g_TxInFlight += data.length;
+	}
+	g_bSerialPending = false;
+}
+
+// Sends a string to the pendant. In binary mode, if a frame type and payload are provided, they are sent instead of the string
+// The messages are always delivered, in order
+function WritePort(text, type, payload)
+{
+	QueuePortMsg({text: text, pos: 0, type: type, payload: payload});
+}
+
+// Sends a message that only matters until a newer one with the same key (like the status). If an older one is still
+// waiting in the queue, it is replaced in place, so the pendant gets the latest state without falling behind.
+// In binary mode getFrame is called to generate the frame right before it is sent
+function WritePortLatest(key, text, getFrame)
+{
+	QueuePortMsg({text: text, pos: 0, key: key, getFrame: getFrame});
+}
+
+// Adds a message to the queue and sends it if possible. If bFirst is set, the message goes ahead of the other queued
+// messages (but after a partially sent one)
+function QueuePortMsg(msg, bFirst)
+{
+	if (!g_PendantPort)
+	{
+		return;
+	}
+
+	if (msg.key != undefined)
+	{
+		var idx = g_SerialQueue.findIndex(m => m.key == msg.key && m.pos == 0 && !m.bEncoded);
+		if (idx >= 0)
+		{
+			if (COM_LOG_LEVEL >= 2) { console.log("REPLACE: ", g_SerialQueue[idx].text); }
+			g_SerialQueue[idx] = msg;
+			return; // the old message was waiting, so nothing can be sent right now
+		}
+	}
+
+	if (bFirst)
+	{
+		g_SerialQueue.splice(g_SerialQueue.length > 0 && g_SerialQueue[0].pos > 0 ? 1 : 0, 0, msg);
+	}
+	else
+	{
+		g_SerialQueue.push(msg);
+	}
+	if (g_bBinaryMode || !g_bSerialPending)
+	{
+		SendPortMsg();
+	}
+}
+
 // Executes a CONTROL macro by name (either G-code or Javascript)
 function ExecuteMacro(macroName)
 {
@@ -1985,7 +2663,9 @@ function TryComHandler(data)
 			$('#DisconnectPendant').removeClass("disabled");
 
 			g_CurrentTryParser.off('data', TryComHandler);
-			g_CurrentTryParser.on('data', PendantComHandler);
+			g_CurrentTryPort.unpipe(g_CurrentTryParser);
+			g_RxBytes = [];
+			g_PendantPort.on('data', PendantDataHandler);
 			g_PendantPort.on('close', function()
 			{
 				printLog("<span class='fg-darkRed'>[ pendant ] </span><span class='fg-blue'>Port disconnected</span>")
@@ -2010,8 +2690,15 @@ function TryComHandler(data)
 			g_StatusCounter = 0;
 
 			localStorage.setItem("PendantPort", g_PendantPort.path);
-			WritePort("SETTINGS");
-			HandleHandshake();
+			g_BaudRate = PENDANT_BAUD_RATE;
+			if (PENDANT_MAX_BAUD_RATE > PENDANT_BAUD_RATE && !g_bBaudFallback)
+			{
+				RequestBaudRate();
+			}
+			else
+			{
+				HandleHandshake();
+			}
 		}
 	}
 }
@@ -2113,6 +2800,11 @@ window.DisconnectPendant = function()
 		g_PendantPort = undefined;
 		g_SerialQueue = [];
 		g_bSerialPending = false;
+		g_bBinaryMode = false;
+		g_RxBytes = [];
+		clearTimeout(g_BaudTimer);
+		g_BaudTimer = undefined;
+		g_bBaudPending = false;
 		$('#ConnectPendant').removeClass("disabled");
 	}
 	$('#pendant > span.icon > span > svg > path').attr("fill", "silver");
@@ -2138,6 +2830,9 @@ var g_RawJoyY;
 var g_JoySetX;
 var g_JoySetY;
 
+// current response curve in the dialog - the response in % at 1/8, 2/8 ... 8/8 of the range
+var g_JoySetCurve;
+
 // current live calibration settings
 var g_JoyCalX;
 var g_JoyCalY;
@@ -2162,11 +2857,159 @@ function ParseJoystickSettings(axis)
 	return [min, max, centerMin, centerMax];
 }
 
+// Returns true if the curve has 8 points between 0 and 100, never goes down, and ends at 100
+function IsValidJoystickCurve(points)
+{
+	if (points.length != 8 || points[7] != 100)
+	{
+		return false;
+	}
+	var last = 0;
+	for (var i = 0; i < 8; i++)
+	{
+		if (!Number.isInteger(points[i]) || points[i] < last || points[i] > 100)
+		{
+			return false;
+		}
+		last = points[i];
+	}
+	return true;
+}
+
+// Returns the joystick response curve as 8 points - the response in % at 1/8, 2/8 ... 8/8 of the range
+// type - "linear", "expo" or "custom". value - the expo amount in %, or the list of 8 points for "custom"
+// Returns undefined if the custom curve is not valid
+function GetJoystickCurve(type, value)
+{
+	var points = [];
+	if (type == "custom")
+	{
+		points = String(value).split(',').map(Number);
+		return IsValidJoystickCurve(points) ? points : undefined;
+	}
+
+	var expo = type == "expo" ? Math.min(Math.max(Number(value), 0), 100) / 100 : 0;
+	for (var i = 1; i <= 8; i++)
+	{
+		var x = i / 8;
+		points.push(Math.round(100 * ((1 - expo) * x + expo * x * x * x)));
+	}
+	return points;
+}
+
+// Returns the type and the value for the controls that produce the given curve
+function GetJoystickCurveControls(points)
+{
+	var str = points.join(",");
+	if (str == GetJoystickCurve("linear").join(","))
+	{
+		return {type: "linear", value: ""};
+	}
+	for (var expo = 1; expo <= 100; expo++)
+	{
+		if (str == GetJoystickCurve("expo", expo).join(","))
+		{
+			return {type: "expo", value: expo};
+		}
+	}
+	return {type: "custom", value: points.join(", ")};
+}
+
+// Returns the distance of the raw joystick value from the center zone in the range [0..1]
+function GetJoystickDistance(raw, calibration)
+{
+	var dist = 0;
+	if (raw < calibration[2])
+	{
+		dist = (calibration[2] - raw) / (calibration[2] - calibration[0]);
+	}
+	else if (raw > calibration[3])
+	{
+		dist = (raw - calibration[3]) / (calibration[1] - calibration[3]);
+	}
+	return Math.min(dist, 1);
+}
+
+// Returns the response of the joystick in the range [0..1] for the raw value, using the calibration and the curve
+function GetJoystickResponse(raw, calibration, curve)
+{
+	var dist = GetJoystickDistance(raw, calibration) * 8;
+	var seg = Math.floor(dist);
+	var lo = seg > 0 ? curve[seg - 1] : 0;
+	var hi = seg < 8 ? curve[seg] : 100;
+	return (lo + (hi - lo) * (dist - seg)) / 100;
+}
+
+// Draws the response curve, with markers for the current X and Y responses
+function DrawJoystickCurve()
+{
+	const Size = 100;
+	const Margin = 10;
+
+	var canvas = document.getElementById("PendantCurveCanvas");
+	if (!canvas || g_JoySetCurve == undefined)
+	{
+		return;
+	}
+	var ctx = canvas.getContext("2d");
+	ctx.clearRect(0, 0, canvas.width, canvas.height);
+
+	ctx.lineWidth = 1;
+	ctx.strokeStyle = "#7F7F7F";
+	ctx.strokeRect(Margin, Margin, Size, Size);
+
+	if (g_bJoyCurveInvalid)
+	{
+		ctx.fillStyle = "#BF0000";
+		ctx.fillText("Invalid curve", Margin + 4, Margin + 12);
+	}
+
+	ctx.lineWidth = 2;
+	ctx.strokeStyle = "#000000";
+	ctx.beginPath();
+	ctx.moveTo(Margin, Margin + Size);
+	for (var i = 0; i < 8; i++)
+	{
+		ctx.lineTo(Margin + (i + 1) * Size / 8, Margin + Size - g_JoySetCurve[i] * Size / 100);
+	}
+	ctx.stroke();
+
+	if (g_RawJoyX != undefined && g_RawJoyY != undefined && g_CalibrationStage == undefined)
+	{
+		var markers = [[g_RawJoyX, g_JoySetX, "#00BF00"], [g_RawJoyY, g_JoySetY, "#0000BF"]];
+		markers.forEach(marker =>
+		{
+			var x = Margin + GetJoystickDistance(marker[0], marker[1]) * Size;
+			var y = Margin + Size - GetJoystickResponse(marker[0], marker[1], g_JoySetCurve) * Size;
+			ctx.fillStyle = marker[2];
+			ctx.beginPath();
+			ctx.arc(x, y, 4, 0, 2 * Math.PI);
+			ctx.fill();
+		});
+	}
+}
+
+// Reads the response curve from the dialog. Returns undefined if the custom curve is not valid
+function ParseJoystickCurve()
+{
+	return GetJoystickCurve($('#PendantJoyCurveType').val(), $('#PendantJoyCurveValue').val());
+}
+
+// set when the custom curve in the dialog is not valid. the preview shows the last valid curve
+var g_bJoyCurveInvalid = false;
+
 // Reads settings from the dialog input fields
 window.RefreshJoystickSettings = function()
 {
 	g_JoySetX = ParseJoystickSettings('X');
 	g_JoySetY = ParseJoystickSettings('Y');
+	var curve = ParseJoystickCurve();
+	g_bJoyCurveInvalid = curve == undefined;
+	if (curve != undefined || g_JoySetCurve == undefined)
+	{
+		g_JoySetCurve = curve != undefined ? curve : g_PendantRomSettings.joyCurve;
+	}
+	DrawJoystickCurve();
 }
 
 // Starts reading the joystick from the pendant and update the graphics
@@ -2237,6 +3080,7 @@ function StartJoystick()
 			calibrateCtx.stroke();
 		}
 
+		DrawJoystickCurve();
 	}, 30);
 }
 
@@ -2396,6 +3240,14 @@ This setting can only be edited while the pendant is connected.">Pendant Name (u
   </div>
 </div>
 
+<div id="PendantTab112" class="row mb-2">
+  <label class="cell-sm-4 pt-1" title="Type up to 4 pairs of wheel speed (clicks per second) and step multiplier, for example 10:1, 25:4, 50:10.
+Turning the wheel faster than the first speed multiplies the step, interpolating between the pairs. Leave empty to always use the exact step">Wheel Acceleration</label>
+  <div class="cell-sm-6">
+    <input id="PendantWheelAccel" data-role="input" data-clear-button="false" data-append="clicks/sec : x" data-editable="true" />
+  </div>
+</div>
+
 <div id="PendantTab16" class="row">
   <label class="cell-sm-4" title="Check if you want the spindle to automatically stop when a job is paused.
 This is done by triggering the door event. Resuming the job will automatically start the spindle, wait 4 seconds, then resume the motion.
@@ -2781,6 +3633,32 @@ The calibration process uses a conservative estimate. If your joystick is more a
       </div>
     </div>
   </div>
+</div>
+
+<div id="PendantTab54" class="row mt-2 pt-1 border-top bd-gray">
+  <div class="cell-sm-6">
+    <div class="row mb-2">
+      <label class="cell-sm-6" title="How the jog speed follows the joystick. Expo makes small movements slower for precise positioning, while keeping the full speed at the edge.
+Custom takes 8 whole numbers - the speed in % at 1/8, 2/8 ... 8/8 of the joystick range. They must never go down, and the last one must be 100">Response Curve</label>
+    </div>
+
+    <div class="row mb-2">
+      <div class="cell-sm-6">
+        <select id="PendantJoyCurveType" data-role="select" data-clear-button="false" data-filter="false" onchange="RefreshJoystickSettings();">
+          <option value="linear">Linear</option>
+          <option value="expo">Expo</option>
+          <option value="custom">Custom</option>
+        </select>
+      </div>
+      <div class="cell-sm-6">
+        <input id="PendantJoyCurveValue" data-role="input" data-clear-button="false" data-editable="true" onchange="RefreshJoystickSettings();"/>
+      </div>
+    </div>
+  </div>
+
+  <div class="cell-sm-6">
+    <canvas id="PendantCurveCanvas" width="120" height="120" />
+  </div>
 </div>`
 
 // Shows or hides a dialog element
@@ -2812,7 +3690,7 @@ window.SelectSettingsTab = function(index)
 	var tab3 = (index == 2);
 	var tab4 = (index == 3);
 	var tab5 = (index == 4);
-	ShowElement($('#PendantTab11,#PendantTab12,#PendantTab13,#PendantTab16,#PendantTab17,#PendantTab18,#PendantTab19,#PendantTab110,#PendantTab111'), tab1);
+	ShowElement($('#PendantTab11,#PendantTab12,#PendantTab13,#PendantTab16,#PendantTab17,#PendantTab18,#PendantTab19,#PendantTab110,#PendantTab111,#PendantTab112'), tab1);
 
 	var safeLimitsDisabled = !$('#PendantSafeLimits').prop('checked');
 	$('#PendantResetSafeLimits,#PendantMinX,#PendantMaxX,#PendantMinY,#PendantMaxY,#PendantMinZ,#PendantMaxZ').prop('disabled', safeLimitsDisabled);
@@ -2834,7 +3712,7 @@ window.SelectSettingsTab = function(index)
 
 	ShowElement($('#PendantTab41,#PendantTab42,#PendantTab43,#PendantTab44,#PendantTab45,#PendantTab46,#PendantTab47,#PendantTab48'), tab4);
 
-	ShowElement($('#PendantTab51,#PendantTab52,#PendantCalibrate,#PendantTab53'), tab5);
+	ShowElement($('#PendantTab51,#PendantTab52,#PendantCalibrate,#PendantTab53,#PendantTab54'), tab5);
 	ShowElement($('#PendantCalibrateCancel'), false);
 
 	if (tab5)
@@ -2891,6 +3769,22 @@ window.ResetSafeLimits = function()
 	}
 }
 
+// Parses the wheel acceleration text - <speed>:<multiplier>, ... - keeping up to 4 pairs with increasing speeds
+function ParseWheelAccel(text)
+{
+	var points = [];
+	text.split(',').forEach(pair =>
+	{
+		var values = pair.split(':').map(Number);
+		var last = points.length > 0 ? points[points.length - 1][0] : 0;
+		if (values.length == 2 && values[0] > last && values[0] <= 255 && values[1] >= 1 && values[1] <= 255 && points.length < 4)
+		{
+			points.push([Math.round(values[0]), Math.round(values[1])]);
+		}
+	});
+	return points;
+}
+
 // Reads the settings from the dialog and saves them
 function ReadSettingsFromDialog(updateRomSettings)
 {
@@ -2900,6 +3794,7 @@ function ReadSettingsFromDialog(updateRomSettings)
 
 	g_PendantSettings.wheelStepsMm = $('#PendantWheelStepsMm').val().split(',').map(Number);
 	g_PendantSettings.wheelStepsIn = $('#PendantWheelStepsIn').val().split(',').map(Number);
+	g_PendantSettings.wheelAccel = ParseWheelAccel($('#PendantWheelAccel').val());
 
 	g_PendantSettings.safeLimitsEnabled = $('#PendantSafeLimits').prop('checked');
 	g_PendantSettings.safeLimitsX = {min: Number($('#PendantMinX').val()), max: Number($('#PendantMaxX').val())};
@@ -2942,6 +3837,11 @@ function ReadSettingsFromDialog(updateRomSettings)
 		g_PendantRomSettings.pendantName = $('#PendantName').val();
 		g_PendantRomSettings.calibrationX = ParseJoystickSettings('X');
 		g_PendantRomSettings.calibrationY = ParseJoystickSettings('Y');
+		var curve = ParseJoystickCurve();
+		if (curve != undefined)
+		{
+			g_PendantRomSettings.joyCurve = curve; // an invalid custom curve keeps the current one
+		}
 	}
 
 	// save to persistent storage and push to the pendant
@@ -2971,6 +3871,7 @@ function UpdateSettingsControls(settings, romSettings)
 	steps = undefined;
 	settings.wheelStepsIn.forEach(s => { steps = steps ? (steps + ", " + s.toFixed(3)) : s.toFixed(3); });
 	$('#PendantWheelStepsIn').val(steps);
+	$('#PendantWheelAccel').val(settings.wheelAccel.map(p => p[0] + ":" + p[1]).join(", "));
 
 	$('#PendantSafeLimits').prop('checked', settings.safeLimitsEnabled);
 
@@ -3085,6 +3986,18 @@ function UpdateSettingsControls(settings, romSettings)
 		$('#PendantJoyMaxY').val(romSettings.calibrationY[1]);
 		$('#PendantJoyCenterMinY').val(romSettings.calibrationY[2]);
 		$('#PendantJoyCenterMaxY').val(romSettings.calibrationY[3]);
+
+		var curve = GetJoystickCurveControls(romSettings.joyCurve);
+		var curveSelect = $('#PendantJoyCurveType').data("select");
+		if (curveSelect)
+		{
+			curveSelect.val(curve.type);
+		}
+		else
+		{
+			$('#PendantJoyCurveType').val(curve.type);
+		}
+		$('#PendantJoyCurveValue').val(curve.value);
 	}
 }
 